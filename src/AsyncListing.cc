@@ -0,0 +1,126 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "AsyncListing.h"
+
+#include <chrono>
+
+namespace /*anonymous*/ {
+
+const size_t DEFAULT_MAX_QUEUED = 16;
+
+// a token cancelled through a copy does not wake waiting threads, so
+// they look at it this often
+const std::chrono::milliseconds CANCEL_POLL(50);
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+AsyncListing::AsyncListing(const std::string& directory, unsigned int fields, const NameMatcher& matcher)
+  : directory_(directory)
+  , fields_(fields)
+  , matcher_(matcher)
+  , max_queued_(DEFAULT_MAX_QUEUED)
+  , done_(false)
+  , finished_(promise_.get_future().share())
+{
+}
+
+AsyncListing::~AsyncListing()
+{
+  cancel();
+  if (thread_.joinable())
+    thread_.join();
+}
+
+void AsyncListing::start(const ChunkCallback& chunk, const DoneCallback& done)
+{
+  if (!thread_.joinable() && !done_)
+    thread_ = std::thread(&AsyncListing::run, this, chunk, done);
+}
+
+void AsyncListing::start()
+{
+  start(ChunkCallback());
+}
+
+void AsyncListing::enqueue(const DirEntries& chunk)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (queue_.size() >= max_queued_ && !token_.cancelled())
+    wake_.wait_for(lock, CANCEL_POLL);
+  if (!token_.cancelled()) {
+    queue_.push_back(chunk);
+    wake_.notify_all();
+  }
+}
+
+void AsyncListing::run(ChunkCallback chunk, DoneCallback done)
+{
+  const ScanBatchCallback batch = chunk ? ScanBatchCallback(chunk)
+      : ScanBatchCallback([this](const DirEntries& c) { enqueue(c); });
+  const bool ok = scan_directory_batches(directory_, fields_, matcher_, batch, token_.flag())
+      && !token_.cancelled();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+  }
+  wake_.notify_all();
+  if (done)
+    done(ok);
+  promise_.set_value(ok);
+}
+
+AsyncListing::NextResult AsyncListing::next(DirEntries& chunk, int timeout)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now()
+      + std::chrono::milliseconds(timeout);
+  while (queue_.empty() && !done_ && !token_.cancelled()) {
+    if (timeout < 0) {
+      wake_.wait_for(lock, CANCEL_POLL);
+    } else {
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      if (now >= end)
+        return TIMEOUT;
+      wake_.wait_for(lock, std::min<std::chrono::steady_clock::duration>(end - now, CANCEL_POLL));
+    }
+  }
+  if (queue_.empty() || token_.cancelled())
+    return END;
+  chunk = std::move(queue_.front());
+  queue_.pop_front();
+  wake_.notify_all();
+  return CHUNK;
+}
+
+} // namespace miutil
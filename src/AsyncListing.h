@@ -0,0 +1,164 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef PUTOOLS_ASYNCLISTING_H
+#define PUTOOLS_ASYNCLISTING_H
+
+#include "miDirtools.h"
+#include "NameMatcher.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace miutil {
+
+/*! \brief Shared flag to ask for work to stop.
+ *
+ * Copies share the flag, so a token may be handed to the code that
+ * decides to cancel, e.g. a GUI button.
+ */
+class CancelToken {
+public:
+  CancelToken()
+    : flag_(std::make_shared<std::atomic<bool> >(false)) { }
+
+  void cancel()
+    { flag_->store(true); }
+
+  bool cancelled() const
+    { return flag_->load(); }
+
+  //! the flag itself, e.g. for scan_directory_batches
+  const std::atomic<bool>* flag() const
+    { return flag_.get(); }
+
+private:
+  std::shared_ptr<std::atomic<bool> > flag_;
+};
+
+/*! \brief List a directory in a background thread.
+ *
+ * Entries are delivered in chunks of at most 1024 as they are read,
+ * either to a callback (push) or to a queue read with next() (pull), so
+ * the first entries can be used long before a large or slow directory
+ * has been read completely. In pull mode, reading pauses while
+ * maxQueued() chunks wait to be taken.
+ *
+ * The listing can be cancelled at any time with cancel() or through a
+ * copy of token(); the destructor cancels and waits for the thread.
+ * Completion is signalled to an optional callback and by finished().
+ */
+class AsyncListing {
+public:
+  typedef std::function<void(const DirEntries& chunk)> ChunkCallback;
+  typedef std::function<void(bool ok)> DoneCallback;
+
+  enum NextResult {
+    CHUNK,    //!< a chunk was returned
+    TIMEOUT,  //!< no chunk yet
+    END       //!< all chunks have been returned, or the listing was cancelled
+  };
+
+  /*!
+   * \param fields bitwise or of ScanFields
+   * \param matcher only entries with matching names are delivered
+   */
+  explicit AsyncListing(const std::string& directory, unsigned int fields = SCAN_NAMES,
+      const NameMatcher& matcher = NameMatcher());
+  ~AsyncListing();
+
+  /*! start reading, calling chunk from the listing thread
+   *
+   * \param done called last from the listing thread, with the value of finished()
+   */
+  void start(const ChunkCallback& chunk, const DoneCallback& done = DoneCallback());
+
+  //! start reading, queueing chunks for next()
+  void start();
+
+  /*! take the next chunk in pull mode
+   * \param timeout milliseconds to wait for a chunk, -1 for no limit
+   */
+  NextResult next(DirEntries& chunk, int timeout = -1);
+
+  void cancel()
+    { token_.cancel(); wake_.notify_all(); }
+
+  //! token to cancel this listing from elsewhere
+  CancelToken token() const
+    { return token_; }
+
+  /*! becomes ready when the listing thread is done
+   *
+   * The value is true if the whole directory was read, false if it
+   * could not be read or the listing was cancelled.
+   */
+  std::shared_future<bool> finished() const
+    { return finished_; }
+
+  size_t maxQueued() const
+    { return max_queued_; }
+
+  //! set before start()
+  void setMaxQueued(size_t chunks)
+    { max_queued_ = chunks > 0 ? chunks : 1; }
+
+private:
+  AsyncListing(const AsyncListing&);
+  AsyncListing& operator=(const AsyncListing&);
+
+  void run(ChunkCallback chunk, DoneCallback done);
+  void enqueue(const DirEntries& chunk);
+
+private:
+  std::string directory_;
+  unsigned int fields_;
+  NameMatcher matcher_;
+  CancelToken token_;
+  size_t max_queued_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;     //!< queue changed, or cancelled
+  std::deque<DirEntries> queue_;
+  bool done_;
+
+  std::promise<bool> promise_;
+  std::shared_future<bool> finished_;
+  std::thread thread_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_ASYNCLISTING_H
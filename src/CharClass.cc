@@ -0,0 +1,188 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "CharClass.h"
+
+#include "miStringFunctions.h"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PUTOOLS_CHARCLASS_SSE2 1
+// AVX2 code is compiled for its own functions only and used if the CPU has it
+#if !defined(__clang__) && (__GNUC__ >= 5)
+#define PUTOOLS_CHARCLASS_AVX2 1
+#endif
+#endif
+
+namespace /*anonymous*/ {
+
+#ifdef PUTOOLS_CHARCLASS_SSE2
+
+/* Return the offset of the first byte in text that is (member=true) or
+ * is not (member=false) one of members, or the length of the part that
+ * was scanned without finding one; the caller scans the rest.
+ */
+size_t scan_sse2(const char* text, size_t length, const unsigned char* members, size_t count, bool member)
+{
+  __m128i sets[miutil::CharClass::MAX_VECTOR_MEMBERS];
+  for (size_t k=0; k<count; ++k)
+    sets[k] = _mm_set1_epi8(static_cast<char>(members[k]));
+  const unsigned int flip = member ? 0 : 0xffff;
+
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+    __m128i hits = _mm_setzero_si128();
+    for (size_t k=0; k<count; ++k)
+      hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, sets[k]));
+    const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hits)) ^ flip;
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+  return i;
+}
+
+#ifdef PUTOOLS_CHARCLASS_AVX2
+
+__attribute__((target("avx2")))
+size_t scan_avx2(const char* text, size_t length, const unsigned char* members, size_t count, bool member)
+{
+  __m256i sets[miutil::CharClass::MAX_VECTOR_MEMBERS];
+  for (size_t k=0; k<count; ++k)
+    sets[k] = _mm256_set1_epi8(static_cast<char>(members[k]));
+  const unsigned int flip = member ? 0 : 0xffffffffu;
+
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+    __m256i hits = _mm256_setzero_si256();
+    for (size_t k=0; k<count; ++k)
+      hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, sets[k]));
+    const unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hits)) ^ flip;
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+  return i;
+}
+
+bool have_avx2()
+{
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+}
+
+#endif // PUTOOLS_CHARCLASS_AVX2
+
+typedef size_t (*scan_f)(const char*, size_t, const unsigned char*, size_t, bool);
+
+scan_f vector_scan()
+{
+#ifdef PUTOOLS_CHARCLASS_AVX2
+  if (have_avx2())
+    return scan_avx2;
+#endif
+  return scan_sse2;
+}
+
+#endif // PUTOOLS_CHARCLASS_SSE2
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+const size_t CharClass::npos;
+const size_t CharClass::MAX_VECTOR_MEMBERS;
+const size_t CharClass::SCALAR_HEAD;
+
+CharClass::CharClass()
+  : size_(0)
+{
+  std::fill(table_, table_ + 256, false);
+}
+
+CharClass::CharClass(const char* chars)
+  : size_(0)
+{
+  std::fill(table_, table_ + 256, false);
+  for (; *chars; ++chars)
+    add(*chars);
+}
+
+void CharClass::add(char c)
+{
+  if (contains(c))
+    return;
+  table_[static_cast<unsigned char>(c)] = true;
+  if (size_ < MAX_VECTOR_MEMBERS)
+    members_[size_] = static_cast<unsigned char>(c);
+  size_ += 1;
+}
+
+size_t CharClass::find(const char* text, size_t length, size_t pos, bool member) const
+{
+#ifdef PUTOOLS_CHARCLASS_SSE2
+  if (size_ <= MAX_VECTOR_MEMBERS) {
+    static const scan_f scan = vector_scan();
+    const size_t n = scan(text + pos, length - pos, members_, size_, member);
+    pos += n;
+    if (pos < length && contains(text[pos]) == member)
+      return pos;
+  }
+#endif
+  for (; pos < length; ++pos) {
+    if (contains(text[pos]) == member)
+      return pos;
+  }
+  return npos;
+}
+
+const CharClass& CharClass::whitespace()
+{
+  static const CharClass ws(whitespaces);
+  return ws;
+}
+
+const char* CharClass::kernel()
+{
+#ifdef PUTOOLS_CHARCLASS_SSE2
+#ifdef PUTOOLS_CHARCLASS_AVX2
+  if (have_avx2())
+    return "avx2";
+#endif
+  return "sse2";
+#else
+  return "scalar";
+#endif
+}
+
+} // namespace miutil
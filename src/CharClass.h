@@ -0,0 +1,127 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef PUTOOLS_CHARCLASS_H
+#define PUTOOLS_CHARCLASS_H
+
+#include <cstddef>
+#include <string>
+
+namespace miutil {
+
+/*! \brief Set of byte values, for scanning text like std::string::find_first_of.
+ *
+ * Membership is a 256-entry table. Sets with up to MAX_VECTOR_MEMBERS
+ * characters, like the whitespace separators, are scanned 16 or 32
+ * bytes at a time with SSE2 or AVX2, chosen when the program runs;
+ * larger sets and other CPUs use the table one byte at a time.
+ *
+ * Positions are as in std::string: npos if nothing is found, and a
+ * start position beyond the end finds nothing.
+ */
+class CharClass {
+public:
+  static const size_t npos = std::string::npos;
+  static const size_t MAX_VECTOR_MEMBERS = 8;
+
+  //! empty set
+  CharClass();
+
+  //! the characters of a NUL-terminated string
+  explicit CharClass(const char* chars);
+
+  void add(char c);
+
+  bool contains(char c) const
+    { return table_[static_cast<unsigned char>(c)]; }
+
+  bool operator()(char c) const
+    { return contains(c); }
+
+  //! number of characters in the set
+  size_t size() const
+    { return size_; }
+
+  //! position of the first member at or after pos
+  size_t find_first_of(const char* text, size_t length, size_t pos = 0) const
+    { return find_head(text, length, pos, true); }
+
+  //! position of the first non-member at or after pos
+  size_t find_first_not_of(const char* text, size_t length, size_t pos = 0) const
+    { return find_head(text, length, pos, false); }
+
+  //! position of the last non-member, or npos
+  size_t find_last_not_of(const char* text, size_t length) const
+    {
+      while (length > 0) {
+        length -= 1;
+        if (!contains(text[length]))
+          return length;
+      }
+      return npos;
+    }
+
+  //! the characters in miutil::whitespaces
+  static const CharClass& whitespace();
+
+  //! "avx2", "sse2" or "scalar", for the kernel used on this CPU
+  static const char* kernel();
+
+private:
+  // bytes looked at inline before the vector kernels are used
+  static const size_t SCALAR_HEAD = 16;
+
+  // tokens and separator runs are often short and found here
+  size_t find_head(const char* text, size_t length, size_t pos, bool member) const
+    {
+      if (pos >= length)
+        return npos;
+      const size_t head = (length - pos > SCALAR_HEAD) ? pos + SCALAR_HEAD : length;
+      if (member) {
+        for (; pos < head; ++pos)
+          if (contains(text[pos]))
+            return pos;
+      } else {
+        for (; pos < head; ++pos)
+          if (!contains(text[pos]))
+            return pos;
+      }
+      return (pos < length) ? find(text, length, pos, member) : npos;
+    }
+
+  size_t find(const char* text, size_t length, size_t pos, bool member) const;
+
+private:
+  bool table_[256];
+  unsigned char members_[MAX_VECTOR_MEMBERS];
+  size_t size_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_CHARCLASS_H
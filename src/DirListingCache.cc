@@ -0,0 +1,447 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "DirListingCache.h"
+
+#include "NameMatcher.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace /*anonymous*/ {
+
+const size_t DEFAULT_HISTORY = 4;
+
+// well below the default inotify max_user_watches of 8192
+const size_t DEFAULT_MAX_DIRECTORIES = 1024;
+
+// a directory changed this recently may change again without a new mtime
+const int64_t RACY_SECONDS = 2;
+
+#ifdef __linux__
+const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+    | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+bool item_less(const miutil::DirListingCache::Item& a, const miutil::DirListingCache::Item& b)
+{
+  return a.name < b.name;
+}
+
+bool same_item(const miutil::DirListingCache::Item& a, const miutil::DirListingCache::Item& b)
+{
+  return a.inode == b.inode && a.mtime == b.mtime && a.size == b.size && a.type == b.type;
+}
+
+bool same_items(const std::vector<miutil::DirListingCache::Item>& a,
+    const std::vector<miutil::DirListingCache::Item>& b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (size_t i=0; i<a.size(); ++i) {
+    if (a[i].name != b[i].name || !same_item(a[i], b[i]))
+      return false;
+  }
+  return true;
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+const DirListingCache::Item* DirListingCache::Listing::find(const std::string& name) const
+{
+  Item key;
+  key.name = name;
+  std::vector<Item>::const_iterator it = std::lower_bound(items.begin(), items.end(), key, item_less);
+  if (it == items.end() || it->name != name)
+    return 0;
+  return &*it;
+}
+
+DirListingCache& DirListingCache::instance()
+{
+  static DirListingCache cache;
+  return cache;
+}
+
+DirListingCache::DirListingCache(bool inotify)
+  : inotify_fd_(-1)
+  , history_(DEFAULT_HISTORY)
+  , max_directories_(DEFAULT_MAX_DIRECTORIES)
+  , uses_(0)
+  , rescans_(0)
+  , snapshots_(0)
+{
+#ifdef __linux__
+  if (inotify)
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+DirListingCache::~DirListingCache()
+{
+  if (inotify_fd_ >= 0)
+    ::close(inotify_fd_);
+}
+
+std::string DirListingCache::key(const std::string& directory)
+{
+  std::string::size_type end = directory.find_last_not_of('/');
+  if (end == std::string::npos)
+    return directory.empty() ? directory : "/";
+  return directory.substr(0, end + 1);
+}
+
+void DirListingCache::readInotify()
+{
+#ifdef __linux__
+  if (inotify_fd_ < 0)
+    return;
+  char buffer[16384] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  while (true) {
+    const ssize_t n = ::read(inotify_fd_, buffer, sizeof(buffer));
+    if (n <= 0) {
+      if (n < 0 && errno == EINTR)
+        continue;
+      break;
+    }
+    for (const char* p = buffer; p < buffer + n; ) {
+      const struct inotify_event* ev = reinterpret_cast<const struct inotify_event*>(p);
+      p += sizeof(struct inotify_event) + ev->len;
+      if (ev->mask & IN_Q_OVERFLOW) {
+        for (directories_t::iterator it = directories_.begin(); it != directories_.end(); ++it)
+          it->second.dirty = true;
+        continue;
+      }
+      // several paths may lead to the same directory and watch
+      typedef std::multimap<int, std::string>::iterator wd_it;
+      const std::pair<wd_it, wd_it> range = wd_directory_.equal_range(ev->wd);
+      for (wd_it w = range.first; w != range.second; ++w) {
+        directories_t::iterator it = directories_.find(w->second);
+        if (it == directories_.end())
+          continue;
+        it->second.dirty = true;
+        if (ev->mask & IN_IGNORED)
+          it->second.wd = -1;
+      }
+      if (ev->mask & IN_IGNORED)
+        wd_directory_.erase(range.first, range.second);
+    }
+  }
+#endif
+}
+
+bool DirListingCache::isValid(const std::string& path, Directory& d) const
+{
+  if (d.history.empty() || d.dirty)
+    return false;
+  if (d.wd >= 0)
+    return true;
+  struct stat st;
+  return stat(path.c_str(), &st) == 0
+      && st.st_mtim.tv_sec == d.mtime_sec && st.st_mtim.tv_nsec == d.mtime_nsec;
+}
+
+DirListingCache::Ptr DirListingCache::refresh(std::unique_lock<std::mutex>& lock,
+    const std::string& path, Directory& d)
+{
+  // watch and stat before reading, so that changes made while reading
+  // are seen by the next get()
+#ifdef __linux__
+  if (inotify_fd_ >= 0 && d.wd < 0) {
+    d.wd = inotify_add_watch(inotify_fd_, path.c_str(), WATCH_MASK);
+    if (d.wd >= 0)
+      wd_directory_.insert(std::make_pair(d.wd, path));
+  }
+#endif
+  d.dirty = false;
+  d.loading = true;
+
+  // other directories may be used while this one is read; d stays valid
+  // as loading entries are neither evicted nor forgotten
+  lock.unlock();
+  struct stat st;
+  const bool found = (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode));
+  std::shared_ptr<Listing> listing;
+  try {
+    DirEntries entries;
+    if (found && scan_directory(path, SCAN_TYPE | SCAN_MTIME | SCAN_SIZE, entries)) {
+      listing = std::make_shared<Listing>();
+      listing->directory = path;
+      listing->items.resize(entries.size());
+      for (size_t i=0; i<entries.size(); ++i) {
+        Item& item = listing->items[i];
+        item.name.assign(entries.name(i), entries.nameLength(i));
+        item.type = entries.type(i);
+        item.inode = entries.inode(i);
+        item.mtime = entries.mtime(i);
+        item.size = entries.fileSize(i);
+      }
+      std::sort(listing->items.begin(), listing->items.end(), item_less);
+    }
+  } catch (...) {
+    lock.lock();
+    d.loading = false;
+    loaded_.notify_all();
+    throw;
+  }
+  lock.lock();
+  d.loading = false;
+  loaded_.notify_all();
+
+  if (!found)
+    return Ptr();
+  rescans_ += 1;
+  d.mtime_sec = st.st_mtim.tv_sec;
+  d.mtime_nsec = st.st_mtim.tv_nsec;
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  if (now.tv_sec - d.mtime_sec < RACY_SECONDS)
+    d.mtime_nsec = -1; // never equal, read again next time
+  if (!listing)
+    return Ptr();
+
+  if (!d.history.empty() && same_items(d.history.back()->items, listing->items))
+    return d.history.back();
+  listing->snapshot = ++snapshots_;
+  d.history.push_back(listing);
+  while (d.history.size() > history_)
+    d.history.pop_front();
+  return listing;
+}
+
+void DirListingCache::forget(directories_t::iterator it)
+{
+#ifdef __linux__
+  const int wd = it->second.wd;
+  if (wd >= 0) {
+    typedef std::multimap<int, std::string>::iterator wd_it;
+    const std::pair<wd_it, wd_it> range = wd_directory_.equal_range(wd);
+    for (wd_it w = range.first; w != range.second; ++w) {
+      if (w->second == it->first) {
+        wd_directory_.erase(w);
+        break;
+      }
+    }
+    if (wd_directory_.count(wd) == 0)
+      inotify_rm_watch(inotify_fd_, wd);
+  }
+#endif
+  directories_.erase(it);
+}
+
+void DirListingCache::evict(directories_t::iterator keep)
+{
+  while (directories_.size() > max_directories_) {
+    directories_t::iterator victim = directories_.end();
+    for (directories_t::iterator it = directories_.begin(); it != directories_.end(); ++it) {
+      if (it != keep && !it->second.loading
+          && (victim == directories_.end() || it->second.used < victim->second.used))
+        victim = it;
+    }
+    if (victim == directories_.end())
+      break;
+    forget(victim);
+  }
+}
+
+DirListingCache::Ptr DirListingCache::get(const std::string& directory)
+{
+  const std::string path = key(directory);
+  std::unique_lock<std::mutex> lock(mutex_);
+  directories_t::iterator it;
+  while (true) {
+    readInotify();
+    it = directories_.find(path);
+    if (it == directories_.end()) {
+      Directory d;
+      d.wd = -1;
+      d.dirty = true;
+      d.loading = false;
+      d.used = 0;
+      d.mtime_sec = d.mtime_nsec = 0;
+      it = directories_.insert(std::make_pair(path, d)).first;
+      evict(it);
+    }
+    if (!it->second.loading)
+      break;
+    // another thread is reading it; the entry may be gone when it is done
+    loaded_.wait(lock);
+  }
+  Directory& d = it->second;
+  d.used = ++uses_;
+  if (isValid(path, d))
+    return d.history.back();
+
+  Ptr listing = refresh(lock, path, d);
+  if (!listing)
+    forget(it);
+  return listing;
+}
+
+bool DirListingCache::diff(const std::string& directory, uint64_t since, Diff& diff)
+{
+  diff = Diff();
+  const Ptr current = get(directory);
+  if (!current)
+    return false;
+  if (since == 0) {
+    diff.added = current->items;
+    return true;
+  }
+
+  Ptr old;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    directories_t::const_iterator it = directories_.find(key(directory));
+    if (it == directories_.end())
+      return false;
+    for (size_t i=0; i<it->second.history.size(); ++i) {
+      if (it->second.history[i]->snapshot == since)
+        old = it->second.history[i];
+    }
+  }
+  if (!old)
+    return false;
+  DirListingCache::diff(*old, *current, diff);
+  return true;
+}
+
+void DirListingCache::diff(const Listing& from, const Listing& to, Diff& diff)
+{
+  diff = Diff();
+  std::vector<Item>::const_iterator f = from.items.begin(), t = to.items.begin();
+  while (f != from.items.end() || t != to.items.end()) {
+    if (t == to.items.end() || (f != from.items.end() && f->name < t->name)) {
+      diff.removed.push_back(*f++);
+    } else if (f == from.items.end() || t->name < f->name) {
+      diff.added.push_back(*t++);
+    } else {
+      if (!same_item(*f, *t))
+        diff.modified.push_back(*t);
+      ++f;
+      ++t;
+    }
+  }
+}
+
+bool DirListingCache::filenames(const std::string& directory, const Predicate& predicate,
+    std::vector<std::string>& names)
+{
+  const Ptr listing = get(directory);
+  if (!listing)
+    return false;
+  for (size_t i=0; i<listing->items.size(); ++i) {
+    if (predicate(listing->items[i]))
+      names.push_back(listing->items[i].name);
+  }
+  return true;
+}
+
+bool DirListingCache::filenamesByExt(const std::string& directory, const std::string& ext,
+    std::vector<std::string>& names)
+{
+  return filenames(directory, NameMatcher::extension(ext), names);
+}
+
+bool DirListingCache::filenames(const std::string& directory, const NameMatcher& matcher,
+    std::vector<std::string>& names)
+{
+  if (!matcher.ok())
+    return false;
+  return filenames(directory, [&matcher](const Item& item) { return matcher.match(item.name); }, names);
+}
+
+void DirListingCache::invalidate(const std::string& directory)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  directories_t::iterator it = directories_.find(key(directory));
+  if (it != directories_.end())
+    it->second.dirty = true;
+}
+
+void DirListingCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  readInotify();
+  for (directories_t::iterator it = directories_.begin(); it != directories_.end(); ) {
+    directories_t::iterator next = it;
+    ++next;
+    if (it->second.loading) {
+      // read again at the next get()
+      it->second.history.clear();
+      it->second.dirty = true;
+    } else {
+      forget(it);
+    }
+    it = next;
+  }
+}
+
+void DirListingCache::setHistory(size_t history)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  history_ = std::max(history, size_t(1));
+  for (directories_t::iterator it = directories_.begin(); it != directories_.end(); ++it) {
+    while (it->second.history.size() > history_)
+      it->second.history.pop_front();
+  }
+}
+
+void DirListingCache::setMaxDirectories(size_t max)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_directories_ = std::max(max, size_t(1));
+  evict(directories_.end());
+}
+
+size_t DirListingCache::maxDirectories() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_directories_;
+}
+
+size_t DirListingCache::rescans() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return rescans_;
+}
+
+} // namespace miutil
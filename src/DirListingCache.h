@@ -0,0 +1,200 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef PUTOOLS_DIRLISTINGCACHE_H
+#define PUTOOLS_DIRLISTINGCACHE_H
+
+#include "miDirtools.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace miutil {
+
+/*! \brief Process-wide cache of directory listings.
+ *
+ * get() returns the listing of a directory from memory as long as the
+ * directory has not changed, and reads it again otherwise. On Linux,
+ * changes are noticed by inotify, which also reports files written in
+ * place; without inotify, the modification time of the directory is
+ * compared, which only changes when entries are added, removed or
+ * renamed. A directory modified within the last two seconds is read
+ * again on each get(), as a second change in the same clock tick would
+ * not change its modification time.
+ *
+ * Each listing that differs from the previous one gets a new snapshot
+ * number, and the last few listings of each directory are kept, so that
+ * diff() can tell which entries were added, removed or modified since a
+ * given snapshot. Listings are shared and never changed, so they remain
+ * valid after the cache has moved on.
+ *
+ * At most maxDirectories() directories are kept; the least recently used
+ * one is forgotten first, also releasing its inotify watch.
+ *
+ * All methods may be called from several threads. Directories are read
+ * without holding the cache lock, so a slow directory only delays
+ * callers asking for the same directory.
+ */
+class DirListingCache {
+public:
+  struct Item {
+    std::string name;
+    DirEntries::Type type;
+    uint64_t inode;
+    int64_t mtime;     //!< modification time, seconds since 1970
+    int64_t size;      //!< size in bytes
+  };
+
+  struct Listing {
+    std::string directory;
+    uint64_t snapshot;        //!< unique in the cache, increasing with each change
+    std::vector<Item> items;  //!< sorted by name, without "." and ".."
+
+    //! item with this name, or 0
+    const Item* find(const std::string& name) const;
+  };
+
+  typedef std::shared_ptr<const Listing> Ptr;
+
+  struct Diff {
+    std::vector<Item> added;
+    std::vector<Item> removed;
+    std::vector<Item> modified;  //!< new version of items with other inode, mtime or size
+
+    bool empty() const
+      { return added.empty() && removed.empty() && modified.empty(); }
+  };
+
+  typedef std::function<bool(const Item&)> Predicate;
+
+  //! the cache shared by the whole process
+  static DirListingCache& instance();
+
+  //! \param inotify false to always compare directory modification times
+  explicit DirListingCache(bool inotify = true);
+  ~DirListingCache();
+
+  //! true if inotify is used
+  bool usesInotify() const
+    { return inotify_fd_ >= 0; }
+
+  /*! current listing of a directory
+   * \return null if the directory cannot be read
+   */
+  Ptr get(const std::string& directory);
+
+  /*! changes of a directory since snapshot since
+   *
+   * Brings the listing up to date first; since 0 means an empty listing,
+   * so that all items are added.
+   * \return false if the directory cannot be read, or if snapshot since
+   *         is no longer kept; then a full listing must be used
+   */
+  bool diff(const std::string& directory, uint64_t since, Diff& diff);
+
+  //! changes from listing from to listing to
+  static void diff(const Listing& from, const Listing& to, Diff& diff);
+
+  //! append the names of items accepted by predicate, in name order
+  bool filenames(const std::string& directory, const Predicate& predicate,
+      std::vector<std::string>& names);
+
+  //! append the names accepted by matcher, in name order
+  bool filenames(const std::string& directory, const NameMatcher& matcher,
+      std::vector<std::string>& names);
+
+  /*! append the names of files with extension ext, like getFilenamesByExt
+   *
+   * As in getFilenamesByExt, a name without '.' is its own extension.
+   */
+  bool filenamesByExt(const std::string& directory, const std::string& ext,
+      std::vector<std::string>& names);
+
+  //! read the directory again at the next get()
+  void invalidate(const std::string& directory);
+
+  //! forget all directories
+  void clear();
+
+  //! number of listings kept per directory, at least 1
+  void setHistory(size_t history);
+
+  //! number of directories kept, at least 1
+  void setMaxDirectories(size_t max);
+
+  size_t maxDirectories() const;
+
+  //! number of times a directory was read, for statistics and tests
+  size_t rescans() const;
+
+private:
+  DirListingCache(const DirListingCache&);
+  DirListingCache& operator=(const DirListingCache&);
+
+  struct Directory {
+    int wd;              //!< inotify watch, or -1
+    bool dirty;
+    bool loading;        //!< being read by refresh, without the lock
+    uint64_t used;       //!< for forgetting the least recently used
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    std::deque<Ptr> history;  //!< oldest first, current last
+  };
+
+  typedef std::map<std::string, Directory> directories_t;
+
+  static std::string key(const std::string& directory);
+  void readInotify();
+  bool isValid(const std::string& path, Directory& d) const;
+  Ptr refresh(std::unique_lock<std::mutex>& lock, const std::string& path, Directory& d);
+  void forget(directories_t::iterator it);
+  void evict(directories_t::iterator keep);
+
+private:
+  mutable std::mutex mutex_;
+  std::condition_variable loaded_;
+  directories_t directories_;
+  std::multimap<int, std::string> wd_directory_; //!< several paths may share a watch
+  int inotify_fd_;
+  size_t history_;
+  size_t max_directories_;
+  uint64_t uses_;
+  size_t rescans_;
+  uint64_t snapshots_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_DIRLISTINGCACHE_H
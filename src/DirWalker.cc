@@ -0,0 +1,195 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "DirWalker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+#include <sys/stat.h>
+
+namespace miutil {
+
+DirWalker::DirWalker(size_t threads)
+  : threads_(threads)
+  , max_depth_(-1)
+  , fields_(SCAN_SIZE | SCAN_MTIME)
+  , pending_(0)
+  , errors_(0)
+  , abort_(false)
+{
+  if (threads_ == 0)
+    threads_ = std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool DirWalker::take(size_t thread, Task& task)
+{
+  // own queue from the back, i.e. depth first with warm caches
+  {
+    Queue& q = queues_[thread];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (!q.tasks.empty()) {
+      task = q.tasks.back();
+      q.tasks.pop_back();
+      return true;
+    }
+  }
+  // steal from the front of the others, i.e. the largest subtrees
+  for (size_t i=1; i<queues_.size(); ++i) {
+    Queue& q = queues_[(thread + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (!q.tasks.empty()) {
+      task = q.tasks.front();
+      q.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void DirWalker::process(size_t thread, const Task& task, DirEntries& entries, const Callback& callback)
+{
+  if (!scan_directory(task.path, fields_ | SCAN_TYPE | SCAN_NOFOLLOW, entries)) {
+    errors_ += 1;
+    return;
+  }
+
+  std::vector<Task> subdirs;
+  for (size_t i=0; i<entries.size() && !abort_; ++i) {
+    Entry e(task.path, entries.name(i));
+    e.type = entries.type(i);
+    e.size = entries.fileSize(i);
+    e.mtime = entries.mtime(i);
+    e.depth = task.depth;
+    e.thread = thread;
+    callback(e);
+
+    if (e.type == DirEntries::TYPE_DIR && (max_depth_ < 0 || task.depth < max_depth_)
+        && (!filter_ || filter_(e)))
+    {
+      Task sub;
+      sub.path = task.path + "/" + e.name;
+      sub.depth = task.depth + 1;
+      subdirs.push_back(sub);
+    }
+  }
+
+  if (!subdirs.empty()) {
+    pending_ += subdirs.size();
+    Queue& q = queues_[thread];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.tasks.insert(q.tasks.end(), subdirs.begin(), subdirs.end());
+  }
+}
+
+void DirWalker::work(size_t thread, const Callback& callback)
+{
+  DirEntries entries;
+  int idle = 0;
+  Task task;
+  while (pending_ > 0 && !abort_) {
+    if (!take(thread, task)) {
+      // others are still listing directories that may have subdirectories
+      if (++idle < 64)
+        std::this_thread::yield();
+      else
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      continue;
+    }
+    idle = 0;
+    process(thread, task, entries, callback);
+    // only now, as subdirectories have been added to pending_ first
+    pending_ -= 1;
+  }
+}
+
+bool DirWalker::walk(const std::string& root, const Callback& callback)
+{
+  struct stat st;
+  if (stat(root.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+    return false;
+
+  std::vector<Queue>(threads_).swap(queues_);
+  errors_ = 0;
+  abort_ = false;
+  Task task;
+  task.path = root;
+  task.depth = 0;
+  queues_[0].tasks.push_back(task);
+  pending_ = 1;
+
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  const Callback guarded = [&](const Entry& e) {
+    try {
+      callback(e);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error)
+        error = std::current_exception();
+      abort_ = true;
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t i=1; i<threads_; ++i)
+    workers.push_back(std::thread(&DirWalker::work, this, i, std::cref(guarded)));
+  work(0, guarded);
+  for (size_t i=0; i<workers.size(); ++i)
+    workers[i].join();
+
+  std::vector<Queue>().swap(queues_);
+  if (error)
+    std::rethrow_exception(error);
+  return true;
+}
+
+bool DirWalker::collect(const std::string& root, std::vector<File>& files)
+{
+  std::vector<std::vector<File> > buffers(threads_);
+  const bool ok = walk(root, [&buffers](const Entry& e) {
+      File f;
+      f.path = e.directory + "/" + e.name;
+      f.type = e.type;
+      f.size = e.size;
+      f.mtime = e.mtime;
+      buffers[e.thread].push_back(f);
+    });
+
+  files.clear();
+  for (size_t i=0; i<buffers.size(); ++i)
+    files.insert(files.end(), buffers[i].begin(), buffers[i].end());
+  return ok;
+}
+
+} // namespace miutil
@@ -0,0 +1,144 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_DIRWALKER_H
+#define PUTOOLS_DIRWALKER_H
+
+#include "miDirtools.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace miutil {
+
+/*! \brief Recursive directory walk on several threads.
+ *
+ * Each thread lists one directory at a time with scan_directory and
+ * queues the subdirectories it finds on its own queue; idle threads
+ * take directories from the other threads' queues. Symbolic links are
+ * reported but never followed.
+ *
+ * The callback is called concurrently from all threads; Entry::thread
+ * can be used to write into per-thread buffers without locking, as
+ * collect() does.
+ */
+class DirWalker {
+public:
+  struct Entry {
+    const std::string& directory; //!< path of the directory, starting with the root
+    const char* name;
+    DirEntries::Type type;
+    int64_t size;                 //!< 0 unless SCAN_SIZE is in fields()
+    int64_t mtime;                //!< 0 unless SCAN_MTIME is in fields()
+    int depth;                    //!< 0 for entries directly in the root
+    size_t thread;                //!< index of the calling thread, < threads()
+
+    Entry(const std::string& d, const char* n)
+      : directory(d), name(n), type(DirEntries::TYPE_UNKNOWN), size(0), mtime(0), depth(0), thread(0) { }
+  };
+
+  typedef std::function<void(const Entry&)> Callback;
+
+  //! return false to skip a directory and everything below it
+  typedef std::function<bool(const Entry&)> Predicate;
+
+  struct File {
+    std::string path;
+    DirEntries::Type type;
+    int64_t size;
+    int64_t mtime;
+  };
+
+  //! \param threads number of threads, 0 for one per processor
+  explicit DirWalker(size_t threads = 0);
+
+  size_t threads() const
+    { return threads_; }
+
+  //! deepest level to descend to, 0 for the root only; -1 (default) for no limit
+  void setMaxDepth(int depth)
+    { max_depth_ = depth; }
+
+  //! ScanFields to read besides name and type, default SCAN_SIZE | SCAN_MTIME
+  void setFields(unsigned int fields)
+    { fields_ = fields; }
+
+  unsigned int fields() const
+    { return fields_; }
+
+  void setDirectoryFilter(const Predicate& filter)
+    { filter_ = filter; }
+
+  /*! walk the tree below root
+   *
+   * If the callback throws, the walk stops and the exception is
+   * rethrown here.
+   * \return false if root cannot be read
+   */
+  bool walk(const std::string& root, const Callback& callback);
+
+  //! walk and return all entries, in no particular order
+  bool collect(const std::string& root, std::vector<File>& files);
+
+  //! number of directories that could not be read during the last walk
+  size_t errors() const
+    { return errors_; }
+
+private:
+  struct Task {
+    std::string path;
+    int depth;
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  bool take(size_t thread, Task& task);
+  void process(size_t thread, const Task& task, DirEntries& entries, const Callback& callback);
+  void work(size_t thread, const Callback& callback);
+
+private:
+  size_t threads_;
+  int max_depth_;
+  unsigned int fields_;
+  Predicate filter_;
+
+  std::vector<Queue> queues_;
+  std::atomic<size_t> pending_;
+  std::atomic<size_t> errors_;
+  std::atomic<bool> abort_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_DIRWALKER_H
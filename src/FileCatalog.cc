@@ -0,0 +1,398 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "FileCatalog.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace miutil {
+
+/* Index file layout, in native byte order:
+ *   Header
+ *   pattern, padded with '\0' to a multiple of 8 bytes
+ *   Record[count], sorted by time, then name
+ *   names, not '\0'-terminated
+ */
+struct FileCatalog::Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t pattern_length;
+  int64_t dir_mtime_sec;
+  int64_t dir_mtime_nsec;
+  uint64_t count;
+  uint64_t names_size;
+};
+
+struct FileCatalog::Record {
+  int64_t time;
+  int64_t mtime;
+  int64_t size;
+  uint32_t name_offset;
+  uint32_t name_length;
+};
+
+} // namespace miutil
+
+namespace /*anonymous*/ {
+
+const char MAGIC[8] = { 'P', 'U', 'T', 'C', 'A', 'T', 0, 0 };
+const uint32_t VERSION = 1;
+
+inline size_t pad8(size_t n)
+{
+  return (n + 7) & ~size_t(7);
+}
+
+// FNV-1a, stable between runs and builds, used to name default index files
+uint64_t fnv1a(const std::string& s)
+{
+  uint64_t h = 14695981039346656037ull;
+  for (size_t i=0; i<s.size(); ++i) {
+    h ^= static_cast<unsigned char>(s[i]);
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+bool write_all(int fd, const char* data, size_t size)
+{
+  while (size > 0) {
+    const ssize_t n = ::write(fd, data, size);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+const char FileCatalog::DEFAULT_INDEX_DIR[] = ".putools-catalog";
+
+FileCatalog::FileCatalog(const std::string& directory, const std::string& pattern,
+    const std::string& indexfile)
+  : directory_(directory)
+  , pattern_(pattern)
+  , indexfile_(indexfile)
+  , data_(0)
+  , size_(0)
+  , mapped_(false)
+{
+  std::string p(pattern);
+  filter_.initFilter(p);
+  if (indexfile_.empty()) {
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx", static_cast<unsigned long long>(fnv1a(pattern_)));
+    indexfile_ = directory_ + "/" + DEFAULT_INDEX_DIR + name;
+  }
+}
+
+FileCatalog::~FileCatalog()
+{
+  unmap();
+}
+
+void FileCatalog::unmap()
+{
+  if (mapped_)
+    munmap(const_cast<char*>(data_), size_);
+  std::vector<char>().swap(buffer_);
+  data_ = 0;
+  size_ = 0;
+  mapped_ = false;
+}
+
+bool FileCatalog::attach(const char* data, size_t size)
+{
+  if (size < sizeof(Header))
+    return false;
+  const Header* h = reinterpret_cast<const Header*>(data);
+  if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != VERSION)
+    return false;
+  if (h->pattern_length != pattern_.size()
+      || size < sizeof(Header) + pad8(h->pattern_length)
+      || pattern_.compare(0, std::string::npos, data + sizeof(Header), h->pattern_length) != 0)
+    return false;
+  const size_t records_offset = sizeof(Header) + pad8(h->pattern_length);
+  if ((size - records_offset) / sizeof(Record) < h->count
+      || size - records_offset - h->count * sizeof(Record) != h->names_size)
+    return false;
+  // the file is not trusted, names must be inside it and times sorted
+  const Record* r = reinterpret_cast<const Record*>(data + records_offset);
+  for (uint64_t i=0; i<h->count; ++i) {
+    if (uint64_t(r[i].name_offset) + r[i].name_length > h->names_size
+        || (i > 0 && r[i].time < r[i-1].time))
+      return false;
+  }
+  data_ = data;
+  size_ = size;
+  return true;
+}
+
+const FileCatalog::Record* FileCatalog::records() const
+{
+  const Header* h = reinterpret_cast<const Header*>(data_);
+  return reinterpret_cast<const Record*>(data_ + sizeof(Header) + pad8(h->pattern_length));
+}
+
+const char* FileCatalog::names() const
+{
+  return reinterpret_cast<const char*>(records() + size());
+}
+
+bool FileCatalog::load()
+{
+  unmap();
+  if (!ok())
+    return false;
+
+  const int fd = ::open(indexfile_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  void* m = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size > 0)
+    m = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (m == MAP_FAILED)
+    return false;
+
+  if (!attach(static_cast<const char*>(m), st.st_size)) {
+    munmap(m, st.st_size);
+    return false;
+  }
+  mapped_ = true;
+  return true;
+}
+
+bool FileCatalog::store(std::vector<char>& buffer)
+{
+  char suffix[32];
+  snprintf(suffix, sizeof(suffix), ".%ld.tmp", static_cast<long>(getpid()));
+  const std::string tmp = indexfile_ + suffix;
+
+  const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd >= 0) {
+    const bool written = write_all(fd, &buffer[0], buffer.size());
+    if (::close(fd) == 0 && written && rename(tmp.c_str(), indexfile_.c_str()) == 0) {
+      if (load())
+        return true;
+    } else {
+      unlink(tmp.c_str());
+    }
+  }
+
+  unmap();
+  buffer_.swap(buffer);
+  return attach(&buffer_[0], buffer_.size());
+}
+
+bool FileCatalog::update(bool rescan)
+{
+  bool changed;
+  return update(rescan, changed);
+}
+
+bool FileCatalog::update(bool rescan, bool& changed)
+{
+  changed = false;
+  if (!ok())
+    return false;
+  if (!data_)
+    load();
+
+  // create the default index directory before looking at the mtime, as
+  // this changes the mtime of the directory
+  const std::string::size_type slash = indexfile_.find_last_of('/');
+  if (slash != std::string::npos && slash > 0)
+    mkdir(indexfile_.substr(0, slash).c_str(), 0755);
+
+  // stat the directory before reading it, so that changes made while
+  // reading are seen by the next update
+  struct stat dst;
+  if (stat(directory_.c_str(), &dst) != 0 || !S_ISDIR(dst.st_mode))
+    return false;
+
+  const Header* h = data_ ? reinterpret_cast<const Header*>(data_) : 0;
+  if (h && !rescan && h->dir_mtime_sec == dst.st_mtim.tv_sec && h->dir_mtime_nsec == dst.st_mtim.tv_nsec)
+    return true;
+
+  DIR* dirp = opendir(directory_.c_str());
+  if (!dirp)
+    return false;
+
+  // names already in the index are not matched and stat'ed again
+  std::unordered_map<std::string, const Record*> known;
+  if (h && !rescan) {
+    const Record* r = records();
+    const char* n = names();
+    known.reserve(h->count);
+    for (size_t i=0; i<h->count; ++i)
+      known[std::string(n + r[i].name_offset, r[i].name_length)] = &r[i];
+  }
+
+  std::vector<Record> recs;
+  std::string blob;
+  std::vector<std::string> new_names;
+  std::vector<packed_time> new_times;
+  while (dirent* dp = readdir(dirp)) {
+    const char* name = dp->d_name;
+    if (dp->d_type == DT_DIR)
+      continue;
+    const size_t length = strlen(name);
+    if (length == 0)
+      continue;
+
+    const std::string sname(name, length);
+    std::unordered_map<std::string, const Record*>::const_iterator it = known.find(sname);
+    if (it != known.end()) {
+      Record rec = *it->second;
+      rec.name_offset = blob.size();
+      rec.name_length = length;
+      blob.append(name, length);
+      recs.push_back(rec);
+    } else {
+      packed_time t;
+      if (!filter_.getTime(sname, t))
+        continue;
+      new_names.push_back(sname);
+      new_times.push_back(t);
+    }
+  }
+  closedir(dirp);
+
+  // stat new files all at once
+  std::vector<FileStat> stats;
+  stat_batch_.stat(directory_, new_names, stats);
+  for (size_t i=0; i<new_names.size(); ++i) {
+    if (stats[i].error != 0 || stats[i].type != DirEntries::TYPE_FILE)
+      continue;
+    Record rec;
+    rec.time = new_times[i];
+    rec.mtime = stats[i].mtime;
+    rec.size = stats[i].size;
+    rec.name_offset = blob.size();
+    rec.name_length = new_names[i].size();
+    blob.append(new_names[i]);
+    recs.push_back(rec);
+  }
+
+  std::sort(recs.begin(), recs.end(), [&blob](const Record& a, const Record& b) {
+      if (a.time != b.time)
+        return a.time < b.time;
+      return blob.compare(a.name_offset, a.name_length, blob, b.name_offset, b.name_length) < 0;
+    });
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.pattern_length = pattern_.size();
+  header.dir_mtime_sec = dst.st_mtim.tv_sec;
+  header.dir_mtime_nsec = dst.st_mtim.tv_nsec;
+  header.count = recs.size();
+  header.names_size = blob.size();
+
+  const size_t records_offset = sizeof(Header) + pad8(pattern_.size());
+  std::vector<char> buffer(records_offset + recs.size() * sizeof(Record) + blob.size(), 0);
+  memcpy(&buffer[0], &header, sizeof(header));
+  memcpy(&buffer[sizeof(Header)], pattern_.data(), pattern_.size());
+  if (!recs.empty())
+    memcpy(&buffer[records_offset], &recs[0], recs.size() * sizeof(Record));
+  if (!blob.empty())
+    memcpy(&buffer[records_offset + recs.size() * sizeof(Record)], blob.data(), blob.size());
+
+  known.clear();
+  changed = true;
+  return store(buffer);
+}
+
+size_t FileCatalog::size() const
+{
+  if (!data_)
+    return 0;
+  return reinterpret_cast<const Header*>(data_)->count;
+}
+
+FileCatalog::Entry FileCatalog::entry(size_t i) const
+{
+  const Record& r = records()[i];
+  Entry e;
+  e.name.assign(names() + r.name_offset, r.name_length);
+  e.time = r.time;
+  e.mtime = r.mtime;
+  e.size = r.size;
+  return e;
+}
+
+size_t FileCatalog::find(packed_time t1, packed_time t2, std::vector<Entry>& entries) const
+{
+  if (!data_ || t2 < t1)
+    return 0;
+  const Record* begin = records();
+  const Record* end = begin + size();
+  const Record* lo = std::lower_bound(begin, end, t1,
+      [](const Record& r, packed_time t) { return r.time < t; });
+  const Record* hi = std::upper_bound(lo, end, t2,
+      [](packed_time t, const Record& r) { return t < r.time; });
+  entries.reserve(entries.size() + (hi - lo));
+  for (const Record* r = lo; r != hi; ++r)
+    entries.push_back(entry(r - begin));
+  return hi - lo;
+}
+
+void FileCatalog::times(std::vector<packed_time>& times) const
+{
+  times.clear();
+  const Record* r = data_ ? records() : 0;
+  for (size_t i=0; i<size(); ++i) {
+    if (times.empty() || times.back() != r[i].time)
+      times.push_back(r[i].time);
+  }
+}
+
+} // namespace miutil
@@ -0,0 +1,148 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_FILECATALOG_H
+#define PUTOOLS_FILECATALOG_H
+
+#include "StatBatch.h"
+#include "TimeFilter.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace miutil {
+
+/*! \brief Persistent index of the files in one directory with their times.
+ *
+ * For each file whose name matches a TimeFilter pattern, the catalog
+ * keeps the name, the time from the name, the modification time and the
+ * size, sorted by time. The index is stored in a binary file that is
+ * memory-mapped, so queries do not touch the directory.
+ *
+ * update() compares the directory modification time with the one stored
+ * in the index and only reads the directory if it has changed. Then
+ * only names not yet in the index are matched and stat'ed; files that
+ * are rewritten in place do not change the directory and keep their
+ * old mtime and size unless update(true) is used.
+ *
+ * By default the index is stored in a subdirectory DEFAULT_INDEX_DIR of
+ * the directory, so that writing it does not change the modification
+ * time of the directory itself; an index file given explicitly should
+ * not be placed directly in the directory for the same reason. If the
+ * index file cannot be written (e.g. a read-only archive), the catalog
+ * is kept in memory only.
+ */
+class FileCatalog {
+public:
+  struct Entry {
+    std::string name;  //!< basename, without directory
+    packed_time time;  //!< time from the name
+    int64_t mtime;     //!< modification time, seconds since 1970
+    int64_t size;      //!< file size in bytes
+  };
+
+  //! subdirectory of the directory for index files if none is given
+  static const char DEFAULT_INDEX_DIR[];
+
+  /*!
+   * \param directory directory to catalog
+   * \param pattern TimeFilter pattern for basenames, e.g. "ec_[yyyymmddHH].grb"
+   * \param indexfile where to store the index; empty means a file named
+   *        after the pattern in DEFAULT_INDEX_DIR
+   */
+  FileCatalog(const std::string& directory, const std::string& pattern,
+      const std::string& indexfile = std::string());
+  ~FileCatalog();
+
+  //! false if the pattern has no time info or contains '/'
+  bool ok() const
+    { return filter_.ok() && filter_.basenameOnly(); }
+
+  const std::string& directory() const
+    { return directory_; }
+
+  const std::string& indexFile() const
+    { return indexfile_; }
+
+  /*! Map an existing index file without looking at the directory.
+   * \return false if there is no valid index for this pattern
+   */
+  bool load();
+
+  /*! Bring the index up to date with the directory.
+   * \param rescan re-stat all files, even if the directory is unchanged
+   * \return false if the directory cannot be read
+   */
+  bool update(bool rescan = false);
+
+  //! like update(), also telling if the index was changed
+  bool update(bool rescan, bool& changed);
+
+  //! number of files in the index
+  size_t size() const;
+
+  //! i'th file in time order
+  Entry entry(size_t i) const;
+
+  /*! Append all files with t1 <= time <= t2 to entries, in time order.
+   * \return number of entries appended
+   */
+  size_t find(packed_time t1, packed_time t2, std::vector<Entry>& entries) const;
+
+  //! distinct times of all files, sorted
+  void times(std::vector<packed_time>& times) const;
+
+private:
+  FileCatalog(const FileCatalog&);
+  FileCatalog& operator=(const FileCatalog&);
+
+  struct Header;
+  struct Record;
+
+  bool attach(const char* data, size_t size);
+  void unmap();
+  const Record* records() const;
+  const char* names() const;
+  bool store(std::vector<char>& buffer);
+
+private:
+  std::string directory_;
+  std::string pattern_;
+  std::string indexfile_;
+  TimeFilter filter_;
+
+  const char* data_;          //!< mapped index file, or buffer_
+  size_t size_;
+  bool mapped_;
+  std::vector<char> buffer_;  //!< index kept in memory if it could not be written
+  StatBatch stat_batch_;      //!< kept, so that its ring is set up only once
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_FILECATALOG_H
@@ -0,0 +1,160 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "FilePrefetcher.h"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace /*anonymous*/ {
+
+const size_t DEFAULT_MAX_QUEUED = 64;
+
+// cancellation is checked between chunks
+const size_t CHUNK_SIZE = 1 << 20;
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+FilePrefetcher::FilePrefetcher(const std::string& directory, size_t threads, Mode mode)
+  : directory_(directory)
+  , mode_(mode)
+  , max_queued_(DEFAULT_MAX_QUEUED)
+  , generation_(0)
+  , files_done_(0)
+  , bytes_done_(0)
+  , pool_(threads)
+{
+}
+
+FilePrefetcher::~FilePrefetcher()
+{
+  cancel();
+}
+
+bool FilePrefetcher::addPattern(const std::string& pattern)
+{
+  std::string p(pattern);
+  TimeFilter f;
+  if (!f.initFilter(p))
+    return false;
+  filters_.push_back(f);
+  return true;
+}
+
+void FilePrefetcher::cancel()
+{
+  generation_ += 1;
+  pool_.clear();
+}
+
+void FilePrefetcher::schedule(const std::vector<packed_time>& times)
+{
+  cancel();
+  const unsigned long generation = generation_;
+
+  size_t queued = 0;
+  std::string name;
+  for (size_t i=0; i<times.size() && queued < max_queued_; ++i) {
+    for (size_t f=0; f<filters_.size() && queued < max_queued_; ++f) {
+      if (!filters_[f].makeName(times[i], name))
+        continue;
+      const std::string path = directory_.empty() ? name : directory_ + "/" + name;
+      pool_.submit([this, path, generation]() { this->fetch(path, generation); });
+      queued += 1;
+    }
+  }
+}
+
+void FilePrefetcher::schedule(const TimeAxis& axis, packed_time current, size_t n)
+{
+  std::vector<packed_time> upcoming;
+  for (size_t i=0; i<axis.size() && upcoming.size() < n; ++i) {
+    const packed_time t = axis.at(i);
+    if ((axis.step() >= 0) ? (t > current) : (t < current))
+      upcoming.push_back(t);
+  }
+  schedule(upcoming);
+}
+
+void FilePrefetcher::fetch(const std::string& path, unsigned long generation)
+{
+  if (generation != generation_)
+    return;
+
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    return;
+  }
+
+  size_t done = 0;
+  if (mode_ == ADVISE) {
+    if (posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED) == 0)
+      done = st.st_size;
+  } else {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#ifndef __linux__
+    std::vector<char> buffer(CHUNK_SIZE);
+#endif
+    const size_t size = st.st_size;
+    while (done < size && generation == generation_) {
+      const size_t n = std::min(CHUNK_SIZE, size - done);
+#ifdef __linux__
+      // into the page cache only, without copying
+      if (readahead(fd, done, n) != 0)
+        break;
+#else
+      if (pread(fd, &buffer[0], n, done) <= 0)
+        break;
+#endif
+      done += n;
+    }
+    if (done < size)
+      done = 0;
+  }
+  ::close(fd);
+
+  if (done > 0 || st.st_size == 0) {
+    files_done_ += 1;
+    bytes_done_ += done;
+  }
+}
+
+} // namespace miutil
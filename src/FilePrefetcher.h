@@ -0,0 +1,115 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_FILEPREFETCHER_H
+#define PUTOOLS_FILEPREFETCHER_H
+
+#include "TimeFilter.h"
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace miutil {
+
+/*! \brief Warm the page cache for the files of upcoming times.
+ *
+ * The files for the requested times are found with TimeFilter::makeName
+ * and read ahead on a small pool of threads, so that opening them later
+ * does not wait for the disk. At most threads() files are read at once
+ * and at most maxQueued() wait; scheduling new times cancels all
+ * requests not yet done, including files being read, which stop at the
+ * next chunk.
+ */
+class FilePrefetcher {
+public:
+  enum Mode {
+    ADVISE, //!< only posix_fadvise(WILLNEED), the kernel reads asynchronously
+    READ    //!< read the whole file in the background
+  };
+
+  /*!
+   * \param directory directory the patterns are relative to
+   * \param threads number of files read at once
+   */
+  explicit FilePrefetcher(const std::string& directory, size_t threads = 2, Mode mode = READ);
+  ~FilePrefetcher();
+
+  //! add a TimeFilter pattern; returns false if it has no valid time info
+  bool addPattern(const std::string& pattern);
+
+  size_t threads() const
+    { return pool_.threads(); }
+
+  size_t maxQueued() const
+    { return max_queued_; }
+
+  void setMaxQueued(size_t n)
+    { max_queued_ = n; }
+
+  //! cancel earlier requests and prefetch the files for these times, in order
+  void schedule(const std::vector<packed_time>& times);
+
+  //! cancel earlier requests and prefetch the files for the next n times after current
+  void schedule(const TimeAxis& axis, packed_time current, size_t n);
+
+  //! cancel all requests
+  void cancel();
+
+  //! block until all requests are done or cancelled
+  void wait()
+    { pool_.wait(); }
+
+  //! number of files prefetched completely since construction
+  size_t filesDone() const
+    { return files_done_; }
+
+  //! number of bytes prefetched since construction
+  size_t bytesDone() const
+    { return bytes_done_; }
+
+private:
+  FilePrefetcher(const FilePrefetcher&);
+  FilePrefetcher& operator=(const FilePrefetcher&);
+
+  void fetch(const std::string& path, unsigned long generation);
+
+private:
+  std::string directory_;
+  Mode mode_;
+  size_t max_queued_;
+  std::vector<TimeFilter> filters_;
+  std::atomic<unsigned long> generation_;
+  std::atomic<size_t> files_done_;
+  std::atomic<size_t> bytes_done_;
+  WorkerPool pool_; // last member, so it stops before the rest is destroyed
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_FILEPREFETCHER_H
@@ -0,0 +1,355 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace /*anonymous*/ {
+
+const int DEFAULT_POLL_INTERVAL = 5000; // milliseconds
+
+int64_t now_ms()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return int64_t(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+FileWatcher::FileWatcher(bool inotify)
+  : inotify_fd_(-1)
+  , poll_interval_(DEFAULT_POLL_INTERVAL)
+  , last_scan_ms_(0)
+  , stop_(false)
+{
+#ifdef __linux__
+  if (inotify)
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+  if (pipe(stop_pipe_) != 0) {
+    stop_pipe_[0] = stop_pipe_[1] = -1;
+  } else {
+    fcntl(stop_pipe_[0], F_SETFL, O_NONBLOCK);
+    fcntl(stop_pipe_[0], F_SETFD, FD_CLOEXEC);
+    fcntl(stop_pipe_[1], F_SETFD, FD_CLOEXEC);
+  }
+}
+
+FileWatcher::~FileWatcher()
+{
+  stop();
+  if (inotify_fd_ >= 0)
+    ::close(inotify_fd_);
+  if (stop_pipe_[0] >= 0) {
+    ::close(stop_pipe_[0]);
+    ::close(stop_pipe_[1]);
+  }
+}
+
+int FileWatcher::addPattern(const std::string& pattern)
+{
+  const int index = patterns_.add(pattern);
+  if (index >= 0)
+    patterns_.compile();
+  return index;
+}
+
+bool FileWatcher::addDirectory(const std::string& directory, bool reportExisting)
+{
+  Watch w;
+  w.directory = directory;
+  w.wd = -1;
+
+  // watch before reading, so that no file arriving in between is missed
+#ifdef __linux__
+  if (inotify_fd_ >= 0) {
+    w.wd = inotify_add_watch(inotify_fd_, directory.c_str(),
+        IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+    if (w.wd < 0)
+      return false;
+    // the same directory, also by another path, gives the same watch
+    if (wd_index_.find(w.wd) != wd_index_.end())
+      return false;
+  }
+#endif
+
+  DIR* dirp = opendir(directory.c_str());
+  if (!dirp) {
+#ifdef __linux__
+    if (w.wd >= 0)
+      inotify_rm_watch(inotify_fd_, w.wd);
+#endif
+    return false;
+  }
+  closedir(dirp);
+
+  watches_.push_back(w);
+  if (w.wd >= 0)
+    wd_index_[w.wd] = watches_.size() - 1;
+  scan(watches_.back(), reportExisting);
+  if (last_scan_ms_ == 0)
+    last_scan_ms_ = now_ms();
+  return true;
+}
+
+bool FileWatcher::match(const Watch& w, const std::string& name, Event& e) const
+{
+  e.pattern = patterns_.match(w.directory + "/" + name, e.time);
+  if (e.pattern < 0)
+    return false;
+  e.directory = w.directory;
+  e.name = name;
+  return true;
+}
+
+void FileWatcher::scan(Watch& w, bool report)
+{
+  DIR* dirp = opendir(w.directory.c_str());
+  if (!dirp)
+    return;
+
+  files_t found;
+  std::vector<Event> events;
+  Event e;
+  while (dirent* dp = readdir(dirp)) {
+    if (dp->d_type == DT_DIR)
+      continue;
+    const std::string name = dp->d_name;
+    if (!match(w, name, e))
+      continue;
+    struct stat st;
+    if (fstatat(dirfd(dirp), dp->d_name, &st, 0) != 0 || !S_ISREG(st.st_mode))
+      continue;
+    const FileState state(st.st_mtime, st.st_ino);
+    found[name] = state;
+
+    // a new inode is a file renamed over the known one
+    files_t::const_iterator it = w.files.find(name);
+    if (it == w.files.end()) {
+      e.type = ARRIVED;
+      events.push_back(e);
+    } else if (it->second != state) {
+      e.type = CLOSED_WRITE;
+      events.push_back(e);
+    }
+  }
+  closedir(dirp);
+
+  for (files_t::const_iterator it = w.files.begin(); it != w.files.end(); ++it) {
+    if (found.find(it->first) == found.end() && match(w, it->first, e)) {
+      e.type = REMOVED;
+      events.push_back(e);
+    }
+  }
+
+  w.files.swap(found);
+  if (report)
+    pending_.insert(pending_.end(), events.begin(), events.end());
+}
+
+void FileWatcher::rescanAll()
+{
+  for (size_t i=0; i<watches_.size(); ++i)
+    scan(watches_[i], true);
+  last_scan_ms_ = now_ms();
+}
+
+void FileWatcher::handle(Watch& w, uint32_t mask, const std::string& name)
+{
+#ifdef __linux__
+  if (mask & IN_ISDIR)
+    return;
+  Event e;
+  if (!match(w, name, e))
+    return;
+
+  if (mask & (IN_CREATE | IN_MOVED_TO | IN_CLOSE_WRITE)) {
+    FileState state;
+    struct stat st;
+    if (stat((w.directory + "/" + name).c_str(), &st) == 0)
+      state = FileState(st.st_mtime, st.st_ino);
+    std::pair<files_t::iterator, bool> known = w.files.insert(std::make_pair(name, state));
+    if (mask & IN_CLOSE_WRITE) {
+      e.type = CLOSED_WRITE;
+    } else if (known.second) {
+      e.type = ARRIVED;
+    } else if (known.first->second == state) {
+      // the same file as seen by the scan in addDirectory
+      return;
+    } else {
+      // renamed over a known file, like a temporary file moved into place
+      e.type = ARRIVED;
+    }
+    known.first->second = state;
+  } else if (mask & (IN_DELETE | IN_MOVED_FROM)) {
+    w.files.erase(name);
+    e.type = REMOVED;
+  } else {
+    return;
+  }
+  pending_.push_back(e);
+#else
+  (void) w;
+  (void) mask;
+  (void) name;
+#endif
+}
+
+void FileWatcher::readInotify()
+{
+#ifdef __linux__
+  alignas(struct inotify_event) char buffer[65536];
+  bool overflow = false;
+  while (true) {
+    const ssize_t n = ::read(inotify_fd_, buffer, sizeof(buffer));
+    if (n <= 0) {
+      if (n < 0 && errno == EINTR)
+        continue;
+      break;
+    }
+    for (ssize_t pos = 0; pos < n; ) {
+      const struct inotify_event* ev = reinterpret_cast<const struct inotify_event*>(buffer + pos);
+      pos += sizeof(struct inotify_event) + ev->len;
+      if (ev->mask & IN_Q_OVERFLOW) {
+        overflow = true;
+        continue;
+      }
+      std::map<int, size_t>::const_iterator it = wd_index_.find(ev->wd);
+      if (it == wd_index_.end() || ev->len == 0)
+        continue;
+      handle(watches_[it->second], ev->mask, ev->name);
+    }
+  }
+  if (overflow)
+    rescanAll();
+#endif
+}
+
+size_t FileWatcher::wait(std::vector<Event>& events, int timeout)
+{
+  const int64_t start = now_ms();
+  while (true) {
+    if (!pending_.empty()) {
+      const size_t count = pending_.size();
+      events.insert(events.end(), pending_.begin(), pending_.end());
+      pending_.clear();
+      return count;
+    }
+    if (stop_)
+      return 0;
+
+    const int64_t now = now_ms();
+    int64_t wait_ms = (timeout < 0) ? -1 : std::max<int64_t>(0, start + timeout - now);
+    if (!usesInotify()) {
+      const int64_t due = last_scan_ms_ + poll_interval_;
+      if (now >= due) {
+        rescanAll();
+        continue;
+      }
+      if (wait_ms < 0 || wait_ms > due - now)
+        wait_ms = due - now;
+    }
+    if (timeout >= 0 && now >= start + timeout)
+      return 0;
+
+    struct pollfd fds[2];
+    nfds_t nfds = 0;
+    if (stop_pipe_[0] >= 0) {
+      fds[nfds].fd = stop_pipe_[0];
+      fds[nfds].events = POLLIN;
+      nfds += 1;
+    }
+    if (usesInotify()) {
+      fds[nfds].fd = inotify_fd_;
+      fds[nfds].events = POLLIN;
+      nfds += 1;
+    }
+    const int r = poll(fds, nfds, wait_ms);
+    if (r < 0 && errno != EINTR)
+      return 0;
+    if (r > 0 && usesInotify() && (fds[nfds-1].revents & POLLIN))
+      readInotify();
+  }
+}
+
+void FileWatcher::run(Callback callback)
+{
+  std::vector<Event> events;
+  while (!stop_) {
+    events.clear();
+    wait(events, -1);
+    for (size_t i=0; i<events.size() && !stop_; ++i)
+      callback(events[i]);
+  }
+}
+
+void FileWatcher::start(const Callback& callback)
+{
+  stop();
+  thread_ = std::thread(&FileWatcher::run, this, callback);
+}
+
+void FileWatcher::stop()
+{
+  if (!thread_.joinable())
+    return;
+  stop_ = true;
+  if (stop_pipe_[1] >= 0) {
+    const char c = 0;
+    if (::write(stop_pipe_[1], &c, 1) < 0) {
+      // cannot fail, the pipe is drained after each stop
+    }
+  }
+  thread_.join();
+  char buffer[16];
+  while (stop_pipe_[0] >= 0 && ::read(stop_pipe_[0], buffer, sizeof(buffer)) > 0)
+    ;
+  stop_ = false;
+}
+
+} // namespace miutil
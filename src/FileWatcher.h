@@ -0,0 +1,156 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_FILEWATCHER_H
+#define PUTOOLS_FILEWATCHER_H
+
+#include "TimeFilterSet.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace miutil {
+
+/*! \brief Stream of file arrivals in watched directories.
+ *
+ * Only files matching one of the TimeFilter patterns are reported, with
+ * the time from their name. On Linux, inotify is used; if the kernel
+ * event queue overflows, the directories are read again and compared to
+ * the files known before, so no arrival or removal is lost. Without
+ * inotify, the directories are read every pollInterval() milliseconds.
+ * When found by reading a directory, new files are reported as ARRIVED
+ * and files with a new mtime or inode as CLOSED_WRITE.
+ *
+ * Patterns and directories must be added before start() is called.
+ */
+class FileWatcher {
+public:
+  enum EventType {
+    ARRIVED,      //!< created in or moved into the directory, also over a known file
+    CLOSED_WRITE, //!< closed after writing, i.e. probably complete
+    REMOVED       //!< deleted or moved away
+  };
+
+  struct Event {
+    EventType type;
+    std::string directory;
+    std::string name;     //!< basename
+    int pattern;          //!< index of the matching pattern
+    packed_time time;     //!< time from the name
+  };
+
+  typedef std::function<void(const Event&)> Callback;
+
+  //! \param inotify false to always use polling
+  explicit FileWatcher(bool inotify = true);
+  ~FileWatcher();
+
+  //! add a TimeFilter pattern; returns its index, or -1 if it has no valid time info
+  int addPattern(const std::string& pattern);
+
+  /*! start watching a directory
+   * \param reportExisting report files already in the directory as ARRIVED
+   * \return false if the directory cannot be read, or if inotify is used
+   *         and the directory is already watched
+   */
+  bool addDirectory(const std::string& directory, bool reportExisting = false);
+
+  //! true if inotify is used, false if polling
+  bool usesInotify() const
+    { return inotify_fd_ >= 0; }
+
+  int pollInterval() const
+    { return poll_interval_; }
+
+  void setPollInterval(int milliseconds)
+    { poll_interval_ = milliseconds; }
+
+  /*! wait for events and append them to events
+   * \param timeout milliseconds to wait if no event is pending, -1 for no limit
+   * \return number of events appended
+   */
+  size_t wait(std::vector<Event>& events, int timeout);
+
+  //! call the callback for each event from a background thread
+  void start(const Callback& callback);
+
+  //! stop the background thread; waits until the current callback returns
+  void stop();
+
+private:
+  FileWatcher(const FileWatcher&);
+  FileWatcher& operator=(const FileWatcher&);
+
+  //! mtime and inode of a known file; mtime -1 if the file could not be read
+  struct FileState {
+    int64_t mtime;
+    uint64_t inode;
+    FileState() : mtime(-1), inode(0) { }
+    FileState(int64_t m, uint64_t i) : mtime(m), inode(i) { }
+    bool operator==(const FileState& o) const
+      { return mtime == o.mtime && inode == o.inode; }
+    bool operator!=(const FileState& o) const
+      { return !(*this == o); }
+  };
+  typedef std::map<std::string, FileState> files_t;
+
+  struct Watch {
+    std::string directory;
+    int wd;
+    files_t files; //!< matching files
+  };
+
+  bool match(const Watch& w, const std::string& name, Event& e) const;
+  void scan(Watch& w, bool report);
+  void rescanAll();
+  void readInotify();
+  void handle(Watch& w, uint32_t mask, const std::string& name);
+  void run(Callback callback);
+
+private:
+  TimeFilterSet patterns_;
+  std::vector<Watch> watches_;
+  std::map<int, size_t> wd_index_;
+  std::deque<Event> pending_;
+
+  int inotify_fd_;
+  int stop_pipe_[2];
+  int poll_interval_;
+  int64_t last_scan_ms_;
+  std::atomic<bool> stop_;
+  std::thread thread_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_FILEWATCHER_H
@@ -0,0 +1,58 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "FormatContext.h"
+
+namespace /*anonymous*/ {
+thread_local const miutil::FormatContext* thread_context = 0;
+} /*anonymous namespace*/
+
+namespace miutil {
+
+// static
+const FormatContext* FormatContext::current()
+{
+  return thread_context;
+}
+
+ScopedFormatContext::ScopedFormatContext(const FormatContext& context)
+  : context_(context)
+  , previous_(thread_context)
+{
+  thread_context = &context_;
+}
+
+ScopedFormatContext::~ScopedFormatContext()
+{
+  thread_context = previous_;
+}
+
+} // namespace miutil
@@ -0,0 +1,85 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_FORMATCONTEXT_H
+#define PUTOOLS_FORMATCONTEXT_H
+
+#include <string>
+
+namespace miutil {
+
+/*! \brief Settings for formatting dates and times.
+ *
+ * A context can be passed explicitly to miTime::format, or installed for
+ * the calling thread with ScopedFormatContext. Formatting functions called
+ * without a language or utf8 flag then take them from the thread's
+ * context instead of the process-wide miDate::setDefaultLanguage, so
+ * threads producing different languages do not share any mutable state.
+ */
+struct FormatContext {
+  //! language code (no/en/de etc.); empty means the process default
+  std::string language;
+
+  //! return names of days and months as utf-8 instead of latin1
+  bool utf8;
+
+  //! time zone name as accepted by miTime::timezone; empty means UTC
+  std::string zone;
+
+  FormatContext()
+    : utf8(false) { }
+
+  explicit FormatContext(const std::string& l, bool u=false, const std::string& z=std::string())
+    : language(l), utf8(u), zone(z) { }
+
+  //! context installed for the calling thread, or 0 if none
+  static const FormatContext* current();
+};
+
+/*! \brief Install a FormatContext for the calling thread.
+ *
+ * The context is active until this object is destroyed; the previous
+ * context is restored then. Instances must be destroyed in the thread
+ * that created them.
+ */
+class ScopedFormatContext {
+public:
+  explicit ScopedFormatContext(const FormatContext& context);
+  ~ScopedFormatContext();
+
+private:
+  ScopedFormatContext(const ScopedFormatContext&);
+  ScopedFormatContext& operator=(const ScopedFormatContext&);
+
+private:
+  const FormatContext context_;
+  const FormatContext* previous_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_FORMATCONTEXT_H
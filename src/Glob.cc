@@ -0,0 +1,291 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "Glob.h"
+
+#include "miDirtools.h"
+
+#include <algorithm>
+
+#include <sys/stat.h>
+
+namespace /*anonymous*/ {
+
+// stop expanding brace sets beyond this many alternatives
+const size_t MAX_ALTERNATIVES = 10000;
+
+/* Expand the first brace set with a ',' at its top level, and then the
+ * others in each result. Braces without ',' or without match are
+ * literal, as in bash.
+ */
+void expand_braces(const std::string& p, std::vector<std::string>& out)
+{
+  if (out.size() >= MAX_ALTERNATIVES)
+    return;
+  for (std::string::size_type i=0; i<p.size(); ++i) {
+    if (p[i] == '\\') {
+      ++i;
+      continue;
+    }
+    if (p[i] != '{')
+      continue;
+
+    int depth = 0;
+    std::string::size_type close = std::string::npos;
+    std::vector<std::string::size_type> commas;
+    for (std::string::size_type j=i; j<p.size(); ++j) {
+      if (p[j] == '\\') {
+        ++j;
+      } else if (p[j] == '{') {
+        depth += 1;
+      } else if (p[j] == '}') {
+        if (--depth == 0) {
+          close = j;
+          break;
+        }
+      } else if (p[j] == ',' && depth == 1) {
+        commas.push_back(j);
+      }
+    }
+    if (close == std::string::npos || commas.empty())
+      continue;
+
+    const std::string prefix = p.substr(0, i), suffix = p.substr(close + 1);
+    commas.push_back(close);
+    std::string::size_type begin = i + 1;
+    for (size_t c=0; c<commas.size(); ++c) {
+      expand_braces(prefix + p.substr(begin, commas[c] - begin) + suffix, out);
+      begin = commas[c] + 1;
+    }
+    return;
+  }
+  out.push_back(p);
+}
+
+bool has_wildcard(const std::string& c)
+{
+  for (std::string::size_type i=0; i<c.size(); ++i) {
+    if (c[i] == '\\')
+      ++i;
+    else if (c[i] == '*' || c[i] == '?' || c[i] == '[')
+      return true;
+  }
+  return false;
+}
+
+std::string unescape(const std::string& c)
+{
+  std::string u;
+  u.reserve(c.size());
+  for (std::string::size_type i=0; i<c.size(); ++i) {
+    if (c[i] == '\\' && i+1 < c.size())
+      ++i;
+    u += c[i];
+  }
+  return u;
+}
+
+std::string join(const std::string& path, const char* name, size_t length)
+{
+  std::string p;
+  p.reserve(path.size() + 1 + length);
+  p = path;
+  if (!p.empty() && p[p.size()-1] != '/')
+    p += '/';
+  p.append(name, length);
+  return p;
+}
+
+bool is_directory(const std::string& path, bool follow)
+{
+  struct stat st;
+  if ((follow ? stat(path.c_str(), &st) : lstat(path.c_str(), &st)) != 0)
+    return false;
+  return S_ISDIR(st.st_mode);
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+Glob::Glob(const std::string& pattern)
+  : pattern_(pattern)
+{
+  expand_braces(pattern_, alternatives_);
+  for (size_t i=0; i<alternatives_.size(); ++i)
+    compile(alternatives_[i]);
+}
+
+void Glob::compile(const std::string& alternative)
+{
+  Alternative a;
+  a.absolute = !alternative.empty() && alternative[0] == '/';
+  a.directories = alternative.size() > 1 && alternative[alternative.size()-1] == '/';
+
+  std::string::size_type begin = 0;
+  while (begin < alternative.size()) {
+    std::string::size_type end = alternative.find('/', begin);
+    if (end == std::string::npos)
+      end = alternative.size();
+    const std::string c = alternative.substr(begin, end - begin);
+    begin = end + 1;
+    if (c.empty())
+      continue;
+
+    Component comp;
+    comp.hidden = (c[0] == '.');
+    if (c == "**") {
+      if (!a.components.empty() && a.components.back().kind == Component::RECURSIVE)
+        continue;
+      comp.kind = Component::RECURSIVE;
+    } else if (has_wildcard(c)) {
+      comp.kind = Component::WILDCARD;
+      comp.matcher = NameMatcher::glob(c);
+    } else {
+      comp.kind = Component::LITERAL;
+      comp.text = unescape(c);
+      if (!a.components.empty() && a.components.back().kind == Component::LITERAL) {
+        a.components.back().text += '/';
+        a.components.back().text += comp.text;
+        continue;
+      }
+    }
+    a.components.push_back(comp);
+  }
+
+  // a final "**" matches everything below
+  if (!a.components.empty() && a.components.back().kind == Component::RECURSIVE) {
+    Component all;
+    all.kind = Component::WILDCARD;
+    all.matcher = NameMatcher::glob("*");
+    all.hidden = false;
+    a.components.push_back(all);
+  }
+  compiled_.push_back(a);
+}
+
+void Glob::walk(const Alternative& a, size_t index, const std::string& path, bool exists,
+    std::vector<std::string>& paths) const
+{
+  if (index == a.components.size()) {
+    if (a.directories) {
+      if (is_directory(path, true))
+        paths.push_back(path + "/");
+    } else if (exists) {
+      paths.push_back(path);
+    } else {
+      struct stat st;
+      if (lstat(path.c_str(), &st) == 0)
+        paths.push_back(path);
+    }
+    return;
+  }
+
+  const Component& c = a.components[index];
+  if (c.kind == Component::LITERAL) {
+    walk(a, index + 1, join(path, c.text.data(), c.text.size()), false, paths);
+    return;
+  }
+
+  const std::string directory = path.empty() ? std::string(".") : path;
+  DirEntries entries;
+  if (c.kind == Component::RECURSIVE) {
+    // one listing for both no directory at all, matching a following
+    // wildcard here, and each subdirectory in turn
+    const bool listed = scan_directory(directory, SCAN_NAMES, entries);
+    const size_t next = index + 1;
+    if (a.components[next].kind == Component::WILDCARD) {
+      if (listed)
+        matchEntries(a, next, path, entries, false, paths);
+    } else {
+      walk(a, next, path, exists, paths);
+    }
+    if (!listed)
+      return;
+    for (size_t i=0; i<entries.size(); ++i) {
+      if (entries.name(i)[0] == '.')
+        continue;
+      const std::string sub = join(path, entries.name(i), entries.nameLength(i));
+      if (entries.type(i) == DirEntries::TYPE_DIR
+          || (entries.type(i) == DirEntries::TYPE_UNKNOWN && is_directory(sub, false)))
+        walk(a, index, sub, true, paths);
+    }
+    return;
+  }
+
+  // WILDCARD
+  if (scan_directory(directory, SCAN_NAMES, c.matcher, entries))
+    matchEntries(a, index, path, entries, true, paths);
+}
+
+void Glob::matchEntries(const Alternative& a, size_t index, const std::string& path,
+    const DirEntries& entries, bool matched, std::vector<std::string>& paths) const
+{
+  // only directories are needed unless this is the last component
+  const Component& c = a.components[index];
+  const bool last = (index + 1 == a.components.size());
+  for (size_t i=0; i<entries.size(); ++i) {
+    if (entries.name(i)[0] == '.' && !c.hidden)
+      continue;
+    if (!matched && !c.matcher.match(entries.name(i), entries.nameLength(i)))
+      continue;
+    const std::string sub = join(path, entries.name(i), entries.nameLength(i));
+    if (last && !a.directories) {
+      paths.push_back(sub);
+      continue;
+    }
+    const DirEntries::Type type = entries.type(i);
+    if (type == DirEntries::TYPE_DIR
+        || ((type == DirEntries::TYPE_LINK || type == DirEntries::TYPE_UNKNOWN) && is_directory(sub, true)))
+      walk(a, index + 1, sub, true, paths);
+  }
+}
+
+size_t Glob::expand(std::vector<std::string>& paths) const
+{
+  paths.clear();
+  for (size_t i=0; i<compiled_.size(); ++i) {
+    const Alternative& a = compiled_[i];
+    if (a.components.empty() && !a.absolute)
+      continue;
+    walk(a, 0, a.absolute ? std::string("/") : std::string(), true, paths);
+  }
+  std::sort(paths.begin(), paths.end());
+  paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+  return paths.size();
+}
+
+size_t expand_glob(const std::string& pattern, std::vector<std::string>& paths)
+{
+  return Glob(pattern).expand(paths);
+}
+
+} // namespace miutil
@@ -0,0 +1,107 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef PUTOOLS_GLOB_H
+#define PUTOOLS_GLOB_H
+
+#include "NameMatcher.h"
+
+#include <string>
+#include <vector>
+
+namespace miutil {
+
+class DirEntries;
+
+/*! \brief Find files with a shell-like pattern.
+ *
+ * Patterns may use '*', '?', "[...]" and '\' escapes within a path
+ * component, "**" as a whole component for any number of directories
+ * (including none), and brace sets like "{ec,arome}", which may be
+ * nested and contain '/'. As in the shell, wildcards do not match names
+ * starting with '.' unless the component starts with '.', "**" does not
+ * enter hidden directories or follow symbolic links, a final "**"
+ * matches everything below, and a pattern ending with '/' matches only
+ * directories.
+ *
+ * The pattern is compiled once: brace sets are expanded, and each
+ * alternative is split into components. Components without wildcards
+ * are appended to the path without reading any directory, so only the
+ * directories where a wildcard must be matched are read, each once also
+ * below "**".
+ */
+class Glob {
+public:
+  explicit Glob(const std::string& pattern);
+
+  const std::string& pattern() const
+    { return pattern_; }
+
+  /*! find all existing paths matching the pattern
+   * \param paths set to the paths, sorted and without duplicates; relative
+   *        if the pattern is relative
+   * \return number of paths
+   */
+  size_t expand(std::vector<std::string>& paths) const;
+
+  //! the pattern without brace sets, for tests
+  const std::vector<std::string>& alternatives() const
+    { return alternatives_; }
+
+private:
+  struct Component {
+    enum Kind { LITERAL, WILDCARD, RECURSIVE } kind;
+    std::string text;     //!< unescaped, for LITERAL maybe several components
+    NameMatcher matcher;  //!< for WILDCARD
+    bool hidden;          //!< matches names starting with '.'
+  };
+
+  struct Alternative {
+    bool absolute;
+    bool directories;     //!< pattern ends with '/'
+    std::vector<Component> components;
+  };
+
+  void compile(const std::string& alternative);
+  void walk(const Alternative& a, size_t index, const std::string& path, bool exists,
+      std::vector<std::string>& paths) const;
+  void matchEntries(const Alternative& a, size_t index, const std::string& path,
+      const DirEntries& entries, bool matched, std::vector<std::string>& paths) const;
+
+private:
+  std::string pattern_;
+  std::vector<std::string> alternatives_;
+  std::vector<Alternative> compiled_;
+};
+
+//! expand a pattern with Glob
+size_t expand_glob(const std::string& pattern, std::vector<std::string>& paths);
+
+} // namespace miutil
+
+#endif // PUTOOLS_GLOB_H
@@ -0,0 +1,363 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "NameMatcher.h"
+
+#include <cctype>
+#include <cstring>
+
+#include <fnmatch.h>
+#include <regex.h>
+
+namespace /*anonymous*/ {
+
+inline bool starts_with(const char* name, size_t length, const std::string& s)
+{
+  return length >= s.size() && memcmp(name, s.data(), s.size()) == 0;
+}
+
+inline bool ends_with(const char* name, size_t length, const std::string& s)
+{
+  return length >= s.size() && memcmp(name + length - s.size(), s.data(), s.size()) == 0;
+}
+
+inline const char* find_in(const char* name, size_t length, const std::string& s)
+{
+  return static_cast<const char*>(memmem(name, length, s.data(), s.size()));
+}
+
+/* Position after the bracket expression starting at pattern[i] == '[',
+ * or npos if it is not closed.
+ */
+std::string::size_type skip_bracket(const std::string& pattern, std::string::size_type i)
+{
+  i += 1;
+  if (i < pattern.size() && (pattern[i] == '^' || pattern[i] == '!'))
+    i += 1;
+  if (i < pattern.size() && pattern[i] == ']')
+    i += 1;
+  while (i < pattern.size()) {
+    if (pattern[i] == '[' && i+1 < pattern.size()
+        && (pattern[i+1] == ':' || pattern[i+1] == '.' || pattern[i+1] == '=')) {
+      // character class like [:digit:]
+      const char close[3] = { pattern[i+1], ']', 0 };
+      const std::string::size_type end = pattern.find(close, i+2);
+      if (end == std::string::npos)
+        return std::string::npos;
+      i = end + 2;
+    } else if (pattern[i] == ']') {
+      return i + 1;
+    } else {
+      i += 1;
+    }
+  }
+  return std::string::npos;
+}
+
+inline bool is_quantifier(char c)
+{
+  return c == '*' || c == '?' || c == '+' || c == '{';
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+struct NameMatcher::Regex {
+  regex_t re;
+  bool compiled;
+
+  explicit Regex(const std::string& pattern)
+    : compiled(regcomp(&re, pattern.c_str(), REG_EXTENDED | REG_NOSUB) == 0) { }
+  ~Regex()
+    { if (compiled) regfree(&re); }
+};
+
+NameMatcher::NameMatcher()
+  : kind_(ANY)
+  , ok_(true)
+  , complete_(true)
+  , exact_(false)
+{
+}
+
+NameMatcher::NameMatcher(Kind kind, const std::string& pattern)
+  : kind_(kind)
+  , pattern_(pattern)
+  , ok_(true)
+  , complete_(true)
+  , exact_(false)
+{
+}
+
+NameMatcher NameMatcher::prefix(const std::string& prefix)
+{
+  return NameMatcher(PREFIX, prefix);
+}
+
+NameMatcher NameMatcher::suffix(const std::string& suffix)
+{
+  return NameMatcher(SUFFIX, suffix);
+}
+
+NameMatcher NameMatcher::extension(const std::string& ext)
+{
+  return NameMatcher(EXTENSION, ext);
+}
+
+NameMatcher NameMatcher::glob(const std::string& pattern)
+{
+  NameMatcher m(GLOB, pattern);
+  m.parseGlob();
+  return m;
+}
+
+NameMatcher NameMatcher::regexp(const std::string& pattern)
+{
+  NameMatcher m(REGEXP, pattern);
+  std::shared_ptr<Regex> r = std::make_shared<Regex>(pattern);
+  m.ok_ = r->compiled;
+  if (m.ok_) {
+    m.regex_ = r;
+    m.parseRegexp();
+  }
+  return m;
+}
+
+void NameMatcher::parseGlob()
+{
+  // split into literal runs and wildcards
+  std::vector<std::string> runs;
+  bool wildcard_first = false, wildcard_last = false, star = false;
+  std::string run;
+  for (std::string::size_type i=0; i<pattern_.size(); ) {
+    const char c = pattern_[i];
+    std::string::size_type next = i + 1;
+    bool wildcard = true;
+    if (c == '*') {
+      star = true;
+    } else if (c == '?') {
+      complete_ = false;
+    } else if (c == '[' && (next = skip_bracket(pattern_, i)) != std::string::npos) {
+      complete_ = false;
+    } else {
+      wildcard = false;
+      next = i + 1;
+      if (c == '\\' && i+1 < pattern_.size())
+        next = i + 2;
+      run += pattern_[next - 1];
+    }
+    if (wildcard) {
+      if (i == 0)
+        wildcard_first = true;
+      if (!run.empty()) {
+        runs.push_back(run);
+        run.clear();
+      }
+    }
+    wildcard_last = wildcard;
+    i = next;
+  }
+  if (!run.empty())
+    runs.push_back(run);
+
+  if (!star && complete_) {
+    exact_ = true;
+    head_ = runs.empty() ? std::string() : runs.front();
+    return;
+  }
+
+  size_t first = 0, last = runs.size();
+  if (!wildcard_first && !runs.empty())
+    head_ = runs[first++];
+  if (!wildcard_last && last > first)
+    tail_ = runs[--last];
+  inner_.assign(runs.begin() + first, runs.begin() + last);
+}
+
+void NameMatcher::parseRegexp()
+{
+  // collect literal text that every match must contain; on anything
+  // unusual, give up and leave the decision to regexec
+  complete_ = false;
+  const std::string& p = pattern_;
+  std::vector<std::string> runs;
+  std::string run;
+  std::string::size_type run_start = 0, first_start = std::string::npos;
+  bool last_literal = false; // previous atom is the last character of run
+  bool tail = false;         // last run ends at a final '$'
+  for (std::string::size_type i=0; i<p.size(); ) {
+    const char c = p[i];
+    std::string::size_type next = i + 1;
+    bool literal = false;
+    if (c == '|') {
+      return;
+    } else if (is_quantifier(c)) {
+      if (i == 0)
+        return;
+      // the quantified character is optional, except with '+'
+      if (last_literal && c != '+')
+        run.erase(run.size() - 1);
+      if (c == '{') {
+        next = p.find('}', i);
+        if (next == std::string::npos)
+          return;
+        next += 1;
+      }
+    } else if (c == '\\') {
+      if (i+1 >= p.size())
+        return;
+      // escaped letters and digits are classes or anchors in GNU regex
+      const unsigned char e = p[i+1];
+      next = i + 2;
+      if (!isalnum(e) && e != '<' && e != '>' && e != '`' && e != '\'') {
+        literal = true;
+        if (run.empty())
+          run_start = i;
+        run += static_cast<char>(e);
+      }
+    } else if (c == '[') {
+      next = skip_bracket(p, i);
+      if (next == std::string::npos)
+        return;
+    } else if (c == '(') {
+      int depth = 0;
+      for (next = i; next < p.size(); ) {
+        if (p[next] == '\\') {
+          next += 2;
+        } else if (p[next] == '[') {
+          next = skip_bracket(p, next);
+          if (next == std::string::npos)
+            return;
+        } else {
+          if (p[next] == '(')
+            depth += 1;
+          else if (p[next] == ')')
+            depth -= 1;
+          next += 1;
+          if (depth == 0)
+            break;
+        }
+      }
+      if (depth != 0)
+        return;
+    } else if (c == ')') {
+      return;
+    } else if (c == '$' && i+1 == p.size()) {
+      tail = !run.empty();
+    } else if (c != '.' && c != '^' && c != '$') {
+      literal = true;
+      if (run.empty())
+        run_start = i;
+      run += c;
+    }
+
+    if (!literal && !run.empty()) {
+      if (runs.empty())
+        first_start = run_start;
+      runs.push_back(run);
+      run.clear();
+    }
+    last_literal = literal;
+    i = next;
+  }
+  if (!run.empty()) {
+    if (runs.empty())
+      first_start = run_start;
+    runs.push_back(run);
+  }
+
+  size_t first = 0, last = runs.size();
+  if (!runs.empty() && p[0] == '^' && first_start == 1)
+    head_ = runs[first++];
+  if (tail && last > first)
+    tail_ = runs[--last];
+  inner_.assign(runs.begin() + first, runs.begin() + last);
+}
+
+bool NameMatcher::literalsMatch(const char* name, size_t length) const
+{
+  if (exact_)
+    return length == head_.size() && memcmp(name, head_.data(), length) == 0;
+  if (!starts_with(name, length, head_) || !ends_with(name, length, tail_))
+    return false;
+  if (complete_) {
+    // head '*' inner '*' ... '*' tail: find inner literals in order, not
+    // overlapping head and tail
+    if (length < head_.size() + tail_.size())
+      return false;
+    const char* pos = name + head_.size();
+    const char* end = name + length - tail_.size();
+    for (size_t i=0; i<inner_.size(); ++i) {
+      const char* f = find_in(pos, end - pos, inner_[i]);
+      if (!f)
+        return false;
+      pos = f + inner_[i].size();
+    }
+  } else {
+    for (size_t i=0; i<inner_.size(); ++i) {
+      if (!find_in(name, length, inner_[i]))
+        return false;
+    }
+  }
+  return true;
+}
+
+bool NameMatcher::match(const char* name, size_t length) const
+{
+  switch (kind_) {
+  case ANY:
+    return true;
+  case PREFIX:
+    return starts_with(name, length, pattern_);
+  case SUFFIX:
+    return ends_with(name, length, pattern_);
+  case EXTENSION: {
+    size_t end = length;
+    if (end > 0 && name[end-1] == '.')
+      end -= 1;
+    const void* dot = memrchr(name, '.', end);
+    const size_t begin = dot ? static_cast<const char*>(dot) - name + 1 : 0;
+    return end - begin == pattern_.size() && memcmp(name + begin, pattern_.data(), pattern_.size()) == 0;
+  }
+  case GLOB:
+    if (!literalsMatch(name, length))
+      return false;
+    return complete_ || fnmatch(pattern_.c_str(), name, 0) == 0;
+  case REGEXP:
+    if (!ok_ || !literalsMatch(name, length))
+      return false;
+    return regexec(&regex_->re, name, 0, 0, 0) == 0;
+  }
+  return false;
+}
+
+} // namespace miutil
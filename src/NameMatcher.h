@@ -0,0 +1,117 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef PUTOOLS_NAMEMATCHER_H
+#define PUTOOLS_NAMEMATCHER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace miutil {
+
+/*! \brief Compiled test for file names.
+ *
+ * A matcher is built once and may then be used for any number of names,
+ * from several threads. Glob and regular expression matchers first check
+ * the literal text that every matching name must contain, so most names
+ * that do not match are rejected without running the full pattern; globs
+ * with '*' as the only wildcard need no more than these checks.
+ *
+ * Matchers are cheap to copy; a compiled regular expression is shared.
+ */
+class NameMatcher {
+public:
+  enum Kind {
+    ANY,        //!< every name
+    PREFIX,
+    SUFFIX,
+    EXTENSION,  //!< text after the last '.', as in getFilenamesByExt
+    GLOB,       //!< shell pattern with '*', '?', "[...]" and '\\' escapes
+    REGEXP      //!< POSIX extended regular expression, unanchored
+  };
+
+  //! matches every name
+  NameMatcher();
+
+  static NameMatcher prefix(const std::string& prefix);
+  static NameMatcher suffix(const std::string& suffix);
+
+  /*! names with extension ext
+   *
+   * As in getFilenamesByExt, a name without '.' is its own extension,
+   * and a single '.' at the end of the name is ignored.
+   */
+  static NameMatcher extension(const std::string& ext);
+
+  static NameMatcher glob(const std::string& pattern);
+  static NameMatcher regexp(const std::string& pattern);
+
+  //! false if the regular expression could not be compiled; then nothing matches
+  bool ok() const
+    { return ok_; }
+
+  Kind kind() const
+    { return kind_; }
+
+  const std::string& pattern() const
+    { return pattern_; }
+
+  /*! test a name
+   * \param name must be '\0'-terminated at length
+   */
+  bool match(const char* name, size_t length) const;
+
+  bool match(const std::string& name) const
+    { return match(name.c_str(), name.size()); }
+
+private:
+  NameMatcher(Kind kind, const std::string& pattern);
+
+  bool literalsMatch(const char* name, size_t length) const;
+  void parseGlob();
+  void parseRegexp();
+
+  struct Regex;
+
+private:
+  Kind kind_;
+  std::string pattern_;
+  bool ok_;
+
+  bool complete_;        //!< the literal checks decide alone
+  bool exact_;           //!< no wildcard, head_ is the whole name
+  std::string head_;     //!< literal start of every match
+  std::string tail_;     //!< literal end of every match
+  std::vector<std::string> inner_; //!< literals in between, in order if complete_
+  std::shared_ptr<const Regex> regex_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_NAMEMATCHER_H
@@ -0,0 +1,195 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "PackedTime.h"
+
+namespace /*anonymous*/ {
+
+const int64_t SECONDS_PER_DAY = 86400;
+
+// days since 1970-01-01 in the proleptic Gregorian calendar
+int64_t days_from_civil(int64_t y, int m, int d)
+{
+  y -= (m <= 2);
+  const int64_t era = (y >= 0 ? y : y-399) / 400;
+  const int64_t yoe = y - era * 400;                                 // [0, 399]
+  const int64_t doy = (153*(m + (m > 2 ? -3 : 9)) + 2)/5 + d-1;      // [0, 365]
+  const int64_t doe = yoe * 365 + yoe/4 - yoe/100 + doy;             // [0, 146096]
+  return era * 146097 + doe - 719468;
+}
+
+void civil_from_days(int64_t z, int& y, int& m, int& d)
+{
+  z += 719468;
+  const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const int64_t doe = z - era * 146097;                              // [0, 146096]
+  const int64_t yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365; // [0, 399]
+  const int64_t doy = doe - (365*yoe + yoe/4 - yoe/100);             // [0, 365]
+  const int64_t mp = (5*doy + 2)/153;                                // [0, 11]
+  d = doy - (153*mp+2)/5 + 1;
+  m = mp + (mp < 10 ? 3 : -9);
+  y = yoe + era * 400 + (m <= 2);
+}
+
+inline bool digits(const char*& p, const char* end, int count, int& value)
+{
+  if (end - p < count)
+    return false;
+  value = 0;
+  for (int i=0; i<count; ++i, ++p) {
+    const char ch = *p;
+    if (ch < '0' || ch > '9')
+      return false;
+    value = 10*value + (ch - '0');
+  }
+  return true;
+}
+
+inline bool expect(const char*& p, const char* end, char ch)
+{
+  if (p == end || *p != ch)
+    return false;
+  ++p;
+  return true;
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+packed_time pack_time(int year, int month, int day, int hour, int minute, int second)
+{
+  return days_from_civil(year, month, day) * SECONDS_PER_DAY
+      + hour*3600 + minute*60 + second;
+}
+
+packed_time pack_time(const miTime& t)
+{
+  if (t.undef())
+    return PACKED_TIME_UNDEF;
+  return pack_time(t.year(), t.month(), t.day(), t.hour(), t.min(), t.sec());
+}
+
+miTime unpack_time(packed_time p)
+{
+  if (p == PACKED_TIME_UNDEF)
+    return miTime();
+
+  int64_t days = p / SECONDS_PER_DAY;
+  int64_t secs = p % SECONDS_PER_DAY;
+  if (secs < 0) {
+    secs += SECONDS_PER_DAY;
+    days -= 1;
+  }
+  int y, m, d;
+  civil_from_days(days, y, m, d);
+  return miTime(y, m, d, secs / 3600, (secs / 60) % 60, secs % 60);
+}
+
+const char* parse_iso_time(const char* begin, const char* end, packed_time& t)
+{
+  const char* p = begin;
+  int year, month, day, hour = 0, minute = 0, second = 0;
+  if (!(digits(p, end, 4, year) && expect(p, end, '-')
+          && digits(p, end, 2, month) && expect(p, end, '-')
+          && digits(p, end, 2, day)))
+    return 0;
+  if (!miDate::isValid(year, month, day) || day == 0)
+    return 0;
+
+  if (p != end && (*p == 'T' || *p == ' ')) {
+    const char* c = p + 1;
+    if (digits(c, end, 2, hour) && expect(c, end, ':') && digits(c, end, 2, minute)) {
+      if (c != end && *c == ':') {
+        ++c;
+        if (!digits(c, end, 2, second))
+          return 0;
+        if (c != end && (*c == '.' || *c == ',')) {
+          ++c;
+          while (c != end && *c >= '0' && *c <= '9')
+            ++c;
+        }
+      }
+      if (!miClock::isValid(hour, minute, second))
+        return 0;
+      p = c;
+      if (p != end && *p == 'Z')
+        ++p;
+    }
+  }
+
+  t = pack_time(year, month, day, hour, minute, second);
+  return p;
+}
+
+void pack_times(const std::vector<miTime>& times, std::vector<packed_time>& packed)
+{
+  packed.resize(times.size());
+  for (size_t i=0; i<times.size(); ++i)
+    packed[i] = pack_time(times[i]);
+}
+
+void unpack_times(const std::vector<packed_time>& packed, std::vector<miTime>& times)
+{
+  times.resize(packed.size());
+  for (size_t i=0; i<packed.size(); ++i)
+    times[i] = unpack_time(packed[i]);
+}
+
+// ========================================================================
+
+bool TimeAxis::index(packed_time t, size_t& i) const
+{
+  if (size_ == 0)
+    return false;
+  if (step_ == 0) {
+    i = 0;
+    return t == start_;
+  }
+  const packed_time offset = t - start_;
+  if (offset % step_ != 0)
+    return false;
+  const packed_time n = offset / step_;
+  if (n < 0 || n >= static_cast<packed_time>(size_))
+    return false;
+  i = n;
+  return true;
+}
+
+std::vector<packed_time> TimeAxis::times() const
+{
+  std::vector<packed_time> t(size_);
+  for (size_t i=0; i<size_; ++i)
+    t[i] = at(i);
+  return t;
+}
+
+} // namespace miutil
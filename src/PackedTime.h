@@ -0,0 +1,112 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_PACKEDTIME_H
+#define PUTOOLS_PACKEDTIME_H
+
+#include "miTime.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace miutil {
+
+/*! Time as a plain integer: seconds since 1970-01-01 00:00:00 UTC.
+ *
+ * Unlike miTime, a packed time is cheap to copy, compare and subtract,
+ * and is what the bulk algorithms on time lists work with.
+ */
+typedef int64_t packed_time;
+
+//! packed value of an undefined miTime
+const packed_time PACKED_TIME_UNDEF = INT64_MIN;
+
+//! Pack date and clock fields without any validation.
+packed_time pack_time(int year, int month, int day, int hour=0, int minute=0, int second=0);
+
+//! Pack a miTime; returns PACKED_TIME_UNDEF if t is undefined.
+packed_time pack_time(const miTime& t);
+
+//! Unpack; returns an undefined miTime for PACKED_TIME_UNDEF.
+miTime unpack_time(packed_time p);
+
+/*! Parse an ISO 8601 time like "2015-02-01 18:00:00", "2015-02-01T18:00Z"
+ * or "2015-02-01" (fractional seconds are accepted and ignored).
+ * Parsing stops at the first character that does not belong to the time.
+ * \return pointer behind the parsed text, or 0 if there is no valid time
+ */
+const char* parse_iso_time(const char* begin, const char* end, packed_time& t);
+
+void pack_times(const std::vector<miTime>& times, std::vector<packed_time>& packed);
+void unpack_times(const std::vector<packed_time>& packed, std::vector<miTime>& times);
+
+/*! \brief A regular time axis: start, start+step, ..., start+(size-1)*step.
+ */
+class TimeAxis {
+public:
+  TimeAxis()
+    : start_(0), step_(0), size_(0) { }
+
+  TimeAxis(packed_time start, packed_time step, size_t size)
+    : start_(start), step_(step), size_(size) { }
+
+  packed_time start() const
+    { return start_; }
+
+  packed_time step() const
+    { return step_; }
+
+  size_t size() const
+    { return size_; }
+
+  bool empty() const
+    { return size_ == 0; }
+
+  packed_time at(size_t i) const
+    { return start_ + static_cast<packed_time>(i) * step_; }
+
+  //! last time on the axis; only valid if not empty
+  packed_time last() const
+    { return at(size_ - 1); }
+
+  /*! Find the index of a time on the axis.
+   * \return false if t is not exactly on the axis
+   */
+  bool index(packed_time t, size_t& i) const;
+
+  //! expand to a list of times
+  std::vector<packed_time> times() const;
+
+private:
+  packed_time start_;
+  packed_time step_;
+  size_t size_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_PACKEDTIME_H
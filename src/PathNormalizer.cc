@@ -0,0 +1,219 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "PathNormalizer.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace /*anonymous*/ {
+
+// forget resolved directories when there are more than this
+const size_t MAX_LINKS = 4096;
+
+struct CwdCache {
+  std::mutex mutex;
+  std::string name;
+  dev_t dev;
+  ino_t ino;
+  bool valid;
+
+  CwdCache() : dev(0), ino(0), valid(false) { }
+};
+
+CwdCache& cwd_cache()
+{
+  static CwdCache cache;
+  return cache;
+}
+
+std::string read_cwd()
+{
+  std::vector<char> buffer(256);
+  while (!getcwd(&buffer[0], buffer.size())) {
+    if (errno != ERANGE)
+      return std::string();
+    buffer.resize(buffer.size() * 2);
+  }
+  return std::string(&buffer[0]);
+}
+
+inline bool is_dotdot(const char* begin, const char* end)
+{
+  return end - begin == 2 && begin[0] == '.' && begin[1] == '.';
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+size_t normalize_path(char* path, size_t length)
+{
+  if (length == 0)
+    return 0;
+
+  const bool absolute = (path[0] == '/');
+  char* const base = path + (absolute ? 1 : 0); // output never goes before this
+  char* w = base;
+  const char* r = path;
+  const char* const end = path + length;
+  while (r < end) {
+    while (r < end && *r == '/')
+      ++r;
+    const char* c = r;
+    while (r < end && *r != '/')
+      ++r;
+    const size_t n = r - c;
+    if (n == 0 || (n == 1 && c[0] == '.'))
+      continue;
+
+    if (is_dotdot(c, r)) {
+      // find the last component written
+      char* last = w;
+      while (last > base && last[-1] != '/')
+        --last;
+      if (w > base && !is_dotdot(last, w)) {
+        w = (last > base) ? last - 1 : base;
+        continue;
+      }
+      if (absolute)
+        continue;
+    }
+    if (w > base)
+      *w++ = '/';
+    memmove(w, c, n); // w never passes r
+    w += n;
+  }
+  if (w == path)
+    *w++ = '.';
+  return w - path;
+}
+
+void normalize_path(std::string& path)
+{
+  if (!path.empty())
+    path.resize(normalize_path(&path[0], path.size()));
+}
+
+std::string current_directory()
+{
+  struct stat st;
+  const bool have_stat = (stat(".", &st) == 0);
+
+  CwdCache& c = cwd_cache();
+  std::lock_guard<std::mutex> lock(c.mutex);
+  if (c.valid && have_stat && st.st_dev == c.dev && st.st_ino == c.ino)
+    return c.name;
+  c.name = read_cwd();
+  c.valid = have_stat && !c.name.empty();
+  if (have_stat) {
+    c.dev = st.st_dev;
+    c.ino = st.st_ino;
+  }
+  return c.name;
+}
+
+void refresh_current_directory()
+{
+  CwdCache& c = cwd_cache();
+  std::lock_guard<std::mutex> lock(c.mutex);
+  c.valid = false;
+}
+
+bool change_directory(const std::string& directory)
+{
+  const bool ok = (chdir(directory.c_str()) == 0);
+  refresh_current_directory();
+  return ok;
+}
+
+PathNormalizer::PathNormalizer(bool resolveLinks)
+  : resolve_links_(resolveLinks)
+{
+  refreshCwd();
+}
+
+void PathNormalizer::refreshCwd()
+{
+  cwd_ = current_directory();
+}
+
+void PathNormalizer::clearLinks()
+{
+  links_.clear();
+}
+
+void PathNormalizer::resolve(std::string& path)
+{
+  const std::string::size_type slash = path.find_last_of('/');
+  if (slash == 0 || slash == std::string::npos)
+    return;
+
+  const std::string directory(path, 0, slash);
+  std::unordered_map<std::string, std::string>::const_iterator it = links_.find(directory);
+  if (it == links_.end()) {
+    if (links_.size() >= MAX_LINKS)
+      links_.clear();
+    std::string resolved;
+    if (char* rp = realpath(directory.c_str(), 0)) {
+      resolved = rp;
+      free(rp);
+    }
+    // empty if the directory cannot be resolved
+    it = links_.insert(std::make_pair(directory, resolved)).first;
+  }
+  if (!it->second.empty())
+    path.replace(0, slash, it->second);
+}
+
+void PathNormalizer::normalize(std::string& path)
+{
+  if (path.empty() || path[0] != '/') {
+    path.insert(0, 1, '/');
+    path.insert(0, cwd_);
+  }
+  if (resolve_links_)
+    resolve(path);
+  normalize_path(path);
+}
+
+void PathNormalizer::normalize(std::vector<std::string>& paths)
+{
+  for (size_t i=0; i<paths.size(); ++i)
+    normalize(paths[i]);
+}
+
+} // namespace miutil
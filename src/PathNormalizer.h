@@ -0,0 +1,113 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef PUTOOLS_PATHNORMALIZER_H
+#define PUTOOLS_PATHNORMALIZER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace miutil {
+
+/*! Normalise a path lexically, in place.
+ *
+ * Repeated and trailing '/' and "." components are removed, and ".."
+ * removes the component before it; ".." at the root is dropped, and
+ * leading ".." of a relative path are kept. An empty relative result is
+ * ".". Symbolic links are not looked at, so "a/link/.." gives "a".
+ *
+ * \return the new length, never more than length
+ */
+size_t normalize_path(char* path, size_t length);
+
+//! same as above, for a string
+void normalize_path(std::string& path);
+
+/*! The current working directory.
+ *
+ * The name is cached and only asked for again if "." is another
+ * directory than when it was cached, so a directory renamed while being
+ * the working directory keeps its old name until change_directory or
+ * refresh_current_directory is called.
+ */
+std::string current_directory();
+
+//! forget the cached working directory
+void refresh_current_directory();
+
+//! chdir and update the cached working directory; false if chdir fails
+bool change_directory(const std::string& directory);
+
+/*! \brief Make many paths absolute and normalised.
+ *
+ * The working directory is read once, when the normaliser is made or
+ * refreshCwd() is called. Paths are changed in place, so normalising a
+ * path that is already absolute and normal allocates nothing.
+ *
+ * With resolveLinks, symbolic links in the directory part of a path are
+ * resolved with realpath, remembering the result for each directory, so
+ * many files in a few directories cost few system calls. The last
+ * component is not resolved. Directories that do not exist are
+ * normalised lexically. The remembered directories are not updated if
+ * links change, see clearLinks().
+ *
+ * A normaliser must not be used by several threads at once.
+ */
+class PathNormalizer {
+public:
+  explicit PathNormalizer(bool resolveLinks = false);
+
+  //! the working directory relative paths are made absolute with
+  const std::string& cwd() const
+    { return cwd_; }
+
+  //! read the working directory again, e.g. after chdir
+  void refreshCwd();
+
+  //! make path absolute and normal
+  void normalize(std::string& path);
+
+  //! normalise all paths in place
+  void normalize(std::vector<std::string>& paths);
+
+  //! forget the resolved directories
+  void clearLinks();
+
+private:
+  void resolve(std::string& path);
+
+private:
+  std::string cwd_;
+  bool resolve_links_;
+  std::unordered_map<std::string, std::string> links_; //!< directory -> resolved directory
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_PATHNORMALIZER_H
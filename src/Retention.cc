@@ -0,0 +1,182 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "Retention.h"
+
+#include "miDirtools.h"
+#include "NameMatcher.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace /*anonymous*/ {
+
+// below this many deletions, threads cost more than they save
+const size_t MIN_PARALLEL_DELETIONS = 256;
+
+const size_t DEFAULT_THREADS = 4;
+
+// newest first, equal times by name
+bool newer(const miutil::Retention::File& a, const miutil::Retention::File& b)
+{
+  if (a.time != b.time)
+    return a.time > b.time;
+  return a.name < b.name;
+}
+
+// set errors[i] to errno if file i could not be unlinked; a file that
+// is already gone is not an error
+void unlink_range(int dfd, const std::vector<miutil::Retention::File>& files, size_t begin, size_t end,
+    std::vector<int>& errors)
+{
+  for (size_t i=begin; i<end; ++i) {
+    if (unlinkat(dfd, files[i].name.c_str(), 0) != 0 && errno != ENOENT)
+      errors[i] = errno;
+  }
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+const size_t Retention::KEEP_ALL;
+const packed_time Retention::NO_MAX_AGE;
+
+Retention::Retention(const std::string& directory)
+  : directory_(directory)
+{
+}
+
+int Retention::addRule(const std::string& pattern, size_t keepNewest, packed_time maxAge)
+{
+  if (keepNewest == 0 && maxAge < 0)
+    return -1;
+  const int index = patterns_.add(pattern);
+  if (index < 0)
+    return -1;
+  patterns_.compile();
+  Rule r;
+  r.keep_newest = keepNewest;
+  r.max_age = maxAge;
+  rules_.push_back(r);
+  return index;
+}
+
+bool Retention::run(packed_time now, bool dryRun, Report& report, size_t threads)
+{
+  report = Report();
+  report.ignored = 0;
+
+  // read and delete through the same descriptor, so that all unlinks
+  // go to the directory that was read, even if it is renamed meanwhile
+  const int dfd = open(directory_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dfd < 0)
+    return false;
+
+  // patterns with '/' are matched against the full path, as in FileWatcher
+  std::string path = directory_ + "/";
+  const size_t prefix = path.size();
+
+  std::vector<std::vector<File> > byRule(rules_.size());
+  File f;
+  const bool ok = scan_directory_batches(dfd, SCAN_TYPE | SCAN_NOFOLLOW, NameMatcher(),
+      [&](const DirEntries& entries) {
+        for (size_t i=0; i<entries.size(); ++i) {
+          if (entries.type(i) == DirEntries::TYPE_DIR)
+            continue;
+          path.resize(prefix);
+          path.append(entries.name(i), entries.nameLength(i));
+          f.rule = patterns_.match(path, f.time);
+          if (f.rule < 0) {
+            report.ignored += 1;
+            continue;
+          }
+          f.name.assign(entries.name(i), entries.nameLength(i));
+          byRule[f.rule].push_back(f);
+        }
+      });
+  if (!ok) {
+    close(dfd);
+    return false;
+  }
+
+  for (size_t r=0; r<byRule.size(); ++r) {
+    std::vector<File>& files = byRule[r];
+    std::sort(files.begin(), files.end(), newer);
+    const Rule& rule = rules_[r];
+    for (size_t i=0; i<files.size(); ++i) {
+      const bool keep = (i < rule.keep_newest)
+          || (rule.max_age >= 0 && files[i].time >= now - rule.max_age);
+      (keep ? report.kept : report.deleted).push_back(files[i]);
+    }
+  }
+
+  if (!dryRun && !report.deleted.empty())
+    remove(dfd, report, threads);
+  close(dfd);
+  return true;
+}
+
+void Retention::remove(int dfd, Report& report, size_t threads)
+{
+  const size_t count = report.deleted.size();
+  std::vector<int> errors(count, 0);
+  if (threads == 0)
+    threads = (count < MIN_PARALLEL_DELETIONS) ? 1 : DEFAULT_THREADS;
+  threads = std::max<size_t>(1, std::min(threads, count));
+  if (threads == 1) {
+    unlink_range(dfd, report.deleted, 0, count, errors);
+  } else {
+    std::vector<std::thread> workers;
+    for (size_t t=0; t<threads; ++t) {
+      workers.push_back(std::thread(unlink_range, dfd, std::cref(report.deleted),
+              count * t / threads, count * (t+1) / threads, std::ref(errors)));
+    }
+    for (size_t t=0; t<threads; ++t)
+      workers[t].join();
+  }
+
+  // files that could not be deleted move from deleted to errors
+  size_t kept = 0;
+  for (size_t i=0; i<count; ++i) {
+    if (errors[i] != 0)
+      report.errors.push_back(std::make_pair(report.deleted[i].name, errors[i]));
+    else
+      report.deleted[kept++] = report.deleted[i];
+  }
+  report.deleted.resize(kept);
+}
+
+} // namespace miutil
@@ -0,0 +1,115 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef PUTOOLS_RETENTION_H
+#define PUTOOLS_RETENTION_H
+
+#include "TimeFilterSet.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace miutil {
+
+/*! \brief Delete old files in a directory by the times in their names.
+ *
+ * Each rule has a TimeFilter pattern and keeps the newest files matching
+ * it, the files newer than a maximum age, or both; a file is deleted
+ * only if no criterion of its rule keeps it. A file belongs to the first
+ * rule whose pattern it matches exactly, as in TimeFilterSet; files
+ * matching no rule, directories and names without valid time are never
+ * touched.
+ *
+ * run() opens the directory once, reads it through that descriptor,
+ * decides for all files at once and deletes with unlinkat relative to
+ * the same descriptor, using a few threads for many files. In dry-run
+ * mode nothing is deleted, and the report tells what would be.
+ */
+class Retention {
+public:
+  struct File {
+    std::string name;
+    packed_time time;  //!< from the name
+    int rule;
+  };
+
+  struct Report {
+    std::vector<File> kept;
+    //! deleted, or to be deleted in a dry run; files that vanished
+    //! meanwhile count as deleted
+    std::vector<File> deleted;
+    //! name and errno of files that could not be deleted, not in deleted
+    std::vector<std::pair<std::string, int> > errors;
+    size_t ignored;              //!< entries matching no rule
+  };
+
+  static const size_t KEEP_ALL = size_t(-1);
+  static const packed_time NO_MAX_AGE = -1;
+
+  explicit Retention(const std::string& directory);
+
+  const std::string& directory() const
+    { return directory_; }
+
+  /*! add a rule
+   * \param keepNewest number of newest files to keep, or KEEP_ALL
+   * \param maxAge keep files not older than this many seconds, or NO_MAX_AGE
+   * \return index of the rule, or -1 if the pattern has no valid time
+   *         info or the rule would keep nothing
+   */
+  int addRule(const std::string& pattern, size_t keepNewest,
+      packed_time maxAge = NO_MAX_AGE);
+
+  size_t rules() const
+    { return rules_.size(); }
+
+  /*! apply the rules
+   * \param now time the ages are measured from
+   * \param dryRun only report, do not delete
+   * \param threads threads for deleting; 0 means a few, for many files
+   * \return false if the directory cannot be read
+   */
+  bool run(packed_time now, bool dryRun, Report& report, size_t threads = 0);
+
+private:
+  void remove(int dfd, Report& report, size_t threads);
+
+  struct Rule {
+    size_t keep_newest;
+    packed_time max_age;
+  };
+
+  std::string directory_;
+  TimeFilterSet patterns_;
+  std::vector<Rule> rules_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_RETENTION_H
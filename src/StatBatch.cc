@@ -0,0 +1,403 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "StatBatch.h"
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#if defined(__NR_io_uring_setup) && defined(STATX_TYPE)
+#define PUTOOLS_IO_URING 1
+#endif
+#endif
+#endif
+
+namespace /*anonymous*/ {
+
+// below this many files, one stat after the other is cheapest
+const size_t MIN_BATCH = 32;
+
+// requests in the ring at once
+const unsigned RING_ENTRIES = 256;
+
+miutil::DirEntries::Type type_from_mode(mode_t mode)
+{
+  if (S_ISREG(mode))
+    return miutil::DirEntries::TYPE_FILE;
+  if (S_ISDIR(mode))
+    return miutil::DirEntries::TYPE_DIR;
+  if (S_ISLNK(mode))
+    return miutil::DirEntries::TYPE_LINK;
+  return miutil::DirEntries::TYPE_OTHER;
+}
+
+void set_error(miutil::FileStat& fs, int error)
+{
+  memset(&fs, 0, sizeof(fs));
+  fs.error = error;
+  fs.type = miutil::DirEntries::TYPE_UNKNOWN;
+}
+
+#if defined(__linux__) && defined(STATX_TYPE)
+const unsigned int STATX_FIELDS = STATX_TYPE | STATX_INO | STATX_SIZE | STATX_MTIME | STATX_CTIME;
+
+void from_statx(const struct statx& sx, miutil::FileStat& fs)
+{
+  fs.error = 0;
+  fs.type = type_from_mode(sx.stx_mode);
+  fs.inode = sx.stx_ino;
+  fs.size = sx.stx_size;
+  fs.mtime = sx.stx_mtime.tv_sec;
+  fs.mtime_nsec = sx.stx_mtime.tv_nsec;
+  fs.ctime = sx.stx_ctime.tv_sec;
+}
+#endif
+
+void stat_one(int dfd, const char* name, bool follow, miutil::FileStat& fs)
+{
+#if defined(__linux__) && defined(STATX_TYPE)
+  struct statx sx;
+  if (statx(dfd, name, AT_STATX_SYNC_AS_STAT | (follow ? 0 : AT_SYMLINK_NOFOLLOW), STATX_FIELDS, &sx) != 0)
+    set_error(fs, errno);
+  else
+    from_statx(sx, fs);
+#else
+  struct stat st;
+  if (fstatat(dfd, name, &st, follow ? 0 : AT_SYMLINK_NOFOLLOW) != 0) {
+    set_error(fs, errno);
+    return;
+  }
+  fs.error = 0;
+  fs.type = type_from_mode(st.st_mode);
+  fs.inode = st.st_ino;
+  fs.size = st.st_size;
+  fs.mtime = st.st_mtim.tv_sec;
+  fs.mtime_nsec = st.st_mtim.tv_nsec;
+  fs.ctime = st.st_ctime;
+#endif
+}
+
+void stat_range(int dfd, const std::vector<std::string>* names, size_t begin, size_t end, bool follow,
+    std::vector<miutil::FileStat>* stats)
+{
+  for (size_t i=begin; i<end; ++i)
+    stat_one(dfd, (*names)[i].c_str(), follow, (*stats)[i]);
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+#ifdef PUTOOLS_IO_URING
+
+/* A raw io_uring: submission and completion queues mapped from the
+ * kernel, see io_uring(7). We are the only producer of submissions and
+ * the only consumer of completions, so only the indices shared with the
+ * kernel need atomic access.
+ */
+struct StatBatch::Ring {
+  int fd;
+  void* sq_ptr;
+  size_t sq_size;
+  void* cq_ptr;
+  size_t cq_size;
+  struct io_uring_sqe* sqes;
+  size_t sqes_size;
+  unsigned entries;
+
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  struct io_uring_cqe* cqes;
+
+  // results written by the kernel; kept with the ring, as requests may
+  // still be running if submitting fails
+  std::vector<struct statx> buffers;
+
+  Ring() : fd(-1), sq_ptr(MAP_FAILED), sq_size(0), cq_ptr(MAP_FAILED), cq_size(0),
+      sqes(static_cast<io_uring_sqe*>(MAP_FAILED)), sqes_size(0), entries(0) { }
+  ~Ring();
+
+  bool setup(unsigned entries);
+};
+
+StatBatch::Ring::~Ring()
+{
+  if (sqes != MAP_FAILED)
+    munmap(sqes, sqes_size);
+  if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)
+    munmap(cq_ptr, cq_size);
+  if (sq_ptr != MAP_FAILED)
+    munmap(sq_ptr, sq_size);
+  if (fd >= 0)
+    ::close(fd);
+}
+
+bool StatBatch::Ring::setup(unsigned n)
+{
+  struct io_uring_params p;
+  memset(&p, 0, sizeof(p));
+  fd = syscall(__NR_io_uring_setup, n, &p);
+  if (fd < 0)
+    return false;
+
+  // older kernels do not know IORING_OP_STATX
+  std::vector<char> pbuf(sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op), 0);
+  struct io_uring_probe* probe = reinterpret_cast<struct io_uring_probe*>(&pbuf[0]);
+  if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) < 0
+      || probe->last_op < IORING_OP_STATX
+      || !(probe->ops[IORING_OP_STATX].flags & IO_URING_OP_SUPPORTED))
+    return false;
+
+  sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  const bool single = (p.features & IORING_FEAT_SINGLE_MMAP);
+  if (single)
+    sq_size = cq_size = std::max(sq_size, cq_size);
+  sq_ptr = mmap(0, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (sq_ptr == MAP_FAILED)
+    return false;
+  if (single) {
+    cq_ptr = sq_ptr;
+  } else {
+    cq_ptr = mmap(0, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq_ptr == MAP_FAILED)
+      return false;
+  }
+  sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+  void* s = mmap(0, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (s == MAP_FAILED)
+    return false;
+  sqes = static_cast<struct io_uring_sqe*>(s);
+
+  char* sq = static_cast<char*>(sq_ptr);
+  char* cq = static_cast<char*>(cq_ptr);
+  sq_tail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+  sq_mask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+  sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+  cq_head = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+  cq_tail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+  cq_mask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+  cqes = reinterpret_cast<struct io_uring_cqe*>(cq + p.cq_off.cqes);
+  entries = p.sq_entries;
+  buffers.resize(entries);
+  return true;
+}
+
+#else // !PUTOOLS_IO_URING
+
+struct StatBatch::Ring {
+};
+
+#endif // !PUTOOLS_IO_URING
+
+StatBatch::StatBatch(bool ioUring, size_t threads)
+  : use_ring_(ioUring)
+  , threads_(threads)
+  , ring_(0)
+  , pool_(0)
+{
+}
+
+StatBatch::~StatBatch()
+{
+  delete pool_;
+  delete ring_;
+}
+
+bool StatBatch::setupRing()
+{
+#ifdef PUTOOLS_IO_URING
+  if (use_ring_ && !ring_) {
+    Ring* ring = new Ring;
+    if (ring->setup(RING_ENTRIES))
+      ring_ = ring;
+    else {
+      delete ring;
+      use_ring_ = false;
+    }
+  }
+  return use_ring_;
+#else
+  use_ring_ = false;
+  return false;
+#endif
+}
+
+bool StatBatch::usesIoUring()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return setupRing();
+}
+
+void StatBatch::stat(const std::vector<std::string>& paths, std::vector<FileStat>& stats, bool follow)
+{
+  run(AT_FDCWD, paths, stats, follow);
+}
+
+bool StatBatch::stat(const std::string& directory, const std::vector<std::string>& names,
+    std::vector<FileStat>& stats, bool follow)
+{
+  const int dfd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dfd < 0) {
+    const int error = errno;
+    stats.resize(names.size());
+    for (size_t i=0; i<stats.size(); ++i)
+      set_error(stats[i], error);
+    return false;
+  }
+  run(dfd, names, stats, follow);
+  ::close(dfd);
+  return true;
+}
+
+void StatBatch::run(int dfd, const std::vector<std::string>& names, std::vector<FileStat>& stats, bool follow)
+{
+  stats.resize(names.size());
+  if (names.size() < MIN_BATCH) {
+    stat_range(dfd, &names, 0, names.size(), follow, &stats);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t done = 0;
+  if (setupRing())
+    done = runRing(dfd, names, stats, follow);
+  if (done < names.size())
+    runThreads(dfd, names, done, stats, follow);
+}
+
+size_t StatBatch::runRing(int dfd, const std::vector<std::string>& names, std::vector<FileStat>& stats, bool follow)
+{
+#ifdef PUTOOLS_IO_URING
+  Ring& r = *ring_;
+  const int flags = AT_STATX_SYNC_AS_STAT | (follow ? 0 : AT_SYMLINK_NOFOLLOW);
+  for (size_t begin = 0; begin < names.size(); begin += r.entries) {
+    const unsigned count = std::min<size_t>(r.entries, names.size() - begin);
+
+    unsigned tail = *r.sq_tail;
+    const unsigned mask = *r.sq_mask;
+    for (unsigned i=0; i<count; ++i) {
+      const unsigned index = tail & mask;
+      struct io_uring_sqe* sqe = &r.sqes[index];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = IORING_OP_STATX;
+      sqe->fd = dfd;
+      sqe->addr = reinterpret_cast<uintptr_t>(names[begin + i].c_str());
+      sqe->len = STATX_FIELDS;
+      sqe->off = reinterpret_cast<uintptr_t>(&r.buffers[i]);
+      sqe->statx_flags = flags;
+      sqe->user_data = i;
+      r.sq_array[index] = index;
+      tail += 1;
+    }
+    __atomic_store_n(r.sq_tail, tail, __ATOMIC_RELEASE);
+
+    // submit all, then wait; waiting for more completions than
+    // submitted requests would block forever
+    unsigned submitted = 0, completed = 0;
+    while (completed < count) {
+      const bool submit = (submitted < count);
+      const int n = syscall(__NR_io_uring_enter, r.fd, submit ? count - submitted : 0,
+          submit ? 0 : count - completed, submit ? 0 : IORING_ENTER_GETEVENTS, 0, 0);
+      if (n < 0 || (submit && n == 0)) {
+        if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY))
+          continue;
+        // give up on the ring; requests still running write into its
+        // buffers, so it is kept until the batch is destroyed
+        use_ring_ = false;
+        return begin;
+      }
+      if (submit)
+        submitted += n;
+
+      unsigned head = *r.cq_head;
+      const unsigned ctail = __atomic_load_n(r.cq_tail, __ATOMIC_ACQUIRE);
+      const unsigned cmask = *r.cq_mask;
+      for (; head != ctail; ++head) {
+        const struct io_uring_cqe* cqe = &r.cqes[head & cmask];
+        const size_t i = cqe->user_data;
+        if (cqe->res < 0)
+          set_error(stats[begin + i], -cqe->res);
+        else
+          from_statx(r.buffers[i], stats[begin + i]);
+        completed += 1;
+      }
+      __atomic_store_n(r.cq_head, head, __ATOMIC_RELEASE);
+    }
+  }
+  return names.size();
+#else
+  (void)dfd; (void)names; (void)stats; (void)follow;
+  return 0;
+#endif
+}
+
+void StatBatch::runThreads(int dfd, const std::vector<std::string>& names, size_t begin,
+    std::vector<FileStat>& stats, bool follow)
+{
+  size_t pool_threads = threads_;
+  if (pool_threads == 0)
+    pool_threads = std::max(1u, std::thread::hardware_concurrency());
+  const size_t count = names.size() - begin;
+  const size_t n_threads = std::min(pool_threads, (count + MIN_BATCH - 1) / MIN_BATCH);
+  if (n_threads <= 1) {
+    stat_range(dfd, &names, begin, names.size(), follow, &stats);
+    return;
+  }
+
+  if (!pool_)
+    pool_ = new WorkerPool(pool_threads);
+  const size_t step = (count + n_threads - 1) / n_threads;
+  for (size_t b = begin; b < names.size(); b += step) {
+    const size_t e = std::min(b + step, names.size());
+    pool_->submit([=, &names, &stats]() { stat_range(dfd, &names, b, e, follow, &stats); });
+  }
+  pool_->wait();
+}
+
+} // namespace miutil
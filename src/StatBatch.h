@@ -0,0 +1,121 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef PUTOOLS_STATBATCH_H
+#define PUTOOLS_STATBATCH_H
+
+#include "miDirtools.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace miutil {
+
+class WorkerPool;
+
+struct FileStat {
+  int error;              //!< 0, or errno if the file could not be stat'ed
+  DirEntries::Type type;
+  uint64_t inode;
+  int64_t size;           //!< size in bytes
+  int64_t mtime;          //!< modification time, seconds since 1970
+  int64_t mtime_nsec;
+  int64_t ctime;          //!< status change time, seconds since 1970
+};
+
+/*! \brief Stat many files at once.
+ *
+ * On Linux kernels with io_uring, the statx requests are queued in a
+ * ring shared with the kernel and submitted many at a time, so a batch
+ * costs a few system calls instead of one per file, and the kernel may
+ * work on several requests at once. Where io_uring is not available (old
+ * kernels, or forbidden, e.g. in containers) large batches are stat'ed
+ * by a pool of threads. Small batches are stat'ed one by one.
+ *
+ * Results are given in the order of the input, each with its own error.
+ * The ring or the thread pool is set up for the first large batch and
+ * kept for the next ones. A batch may be used by several threads, one
+ * call at a time.
+ */
+class StatBatch {
+public:
+  /*!
+   * \param ioUring false to never use io_uring
+   * \param threads threads for the fallback; 0 means as many as there are
+   *        processors
+   */
+  explicit StatBatch(bool ioUring = true, size_t threads = 0);
+  ~StatBatch();
+
+  //! true if io_uring can be used for large batches
+  bool usesIoUring();
+
+  /*! stat files
+   *
+   * \param paths absolute, or relative to the working directory
+   * \param stats set to one result per path
+   * \param follow stat what symbolic links point to
+   */
+  void stat(const std::vector<std::string>& paths, std::vector<FileStat>& stats,
+      bool follow = true);
+
+  /*! stat files in one directory
+   *
+   * \param names relative to directory
+   * \return false if the directory cannot be opened; then all stats have its error
+   */
+  bool stat(const std::string& directory, const std::vector<std::string>& names,
+      std::vector<FileStat>& stats, bool follow = true);
+
+private:
+  StatBatch(const StatBatch&);
+  StatBatch& operator=(const StatBatch&);
+
+  struct Ring;
+
+  bool setupRing();
+  void run(int dfd, const std::vector<std::string>& names, std::vector<FileStat>& stats,
+      bool follow);
+  size_t runRing(int dfd, const std::vector<std::string>& names,
+      std::vector<FileStat>& stats, bool follow);
+  void runThreads(int dfd, const std::vector<std::string>& names, size_t begin,
+      std::vector<FileStat>& stats, bool follow);
+
+private:
+  std::mutex mutex_;
+  bool use_ring_;     //!< io_uring wanted and not found to fail
+  size_t threads_;
+  Ring* ring_;
+  WorkerPool* pool_;  //!< for the fallback, made when first needed
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_STATBATCH_H
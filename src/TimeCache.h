@@ -0,0 +1,281 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_TIMECACHE_H
+#define PUTOOLS_TIMECACHE_H
+
+#include "PackedTime.h"
+#include "WorkerPool.h"
+
+#include <map>
+#include <memory>
+#include <set>
+
+namespace miutil {
+
+/*! \brief Cache of data per time, e.g. decoded fields for an animation.
+ *
+ * The cache has a memory budget. When it is exceeded, the entries
+ * farthest away from a movable cursor (the time currently shown) are
+ * evicted first. Upcoming times can be loaded ahead of use on a
+ * background thread through the user-supplied loader.
+ *
+ * All public functions are thread-safe. The loader is called without
+ * holding the cache lock, and may be called from the background thread;
+ * it returns an empty pointer if nothing can be loaded for a time.
+ */
+template<class V>
+class TimeCache {
+public:
+  typedef std::shared_ptr<const V> value_ptr;
+  typedef std::function<value_ptr(packed_time)> Loader;
+  typedef std::function<size_t(const V&)> SizeFunction;
+
+  TimeCache(size_t budget, const Loader& loader, const SizeFunction& sizer=SizeFunction())
+    : budget_(budget), used_(0), cursor_(0), generation_(0), epoch_(0)
+    , loader_(loader), sizer_(sizer), worker_(1) { }
+
+  //! cached value for t, or loaded synchronously if not cached
+  value_ptr get(packed_time t);
+
+  //! cached value for t, or empty if not cached
+  value_ptr find(packed_time t) const;
+
+  void insert(packed_time t, value_ptr value);
+
+  //! move the cursor; entries far from it are evicted first
+  void setCursor(packed_time t);
+
+  packed_time cursor() const
+    { std::lock_guard<std::mutex> lock(mutex_); return cursor_; }
+
+  /*! Load the given times in the background. Prefetches requested
+   * earlier and not yet started are cancelled; those already running
+   * still fill the cache.
+   */
+  void prefetch(const std::vector<packed_time>& upcoming);
+
+  //! prefetch the next n times on the axis after the cursor
+  void prefetch(const TimeAxis& axis, size_t n);
+
+  //! block until all prefetches are done
+  void waitForPrefetch()
+    { worker_.wait(); }
+
+  size_t size() const
+    { std::lock_guard<std::mutex> lock(mutex_); return entries_.size(); }
+
+  size_t memoryUsed() const
+    { std::lock_guard<std::mutex> lock(mutex_); return used_; }
+
+  void clear();
+
+private:
+  TimeCache(const TimeCache&);
+  TimeCache& operator=(const TimeCache&);
+
+  struct Entry {
+    value_ptr value;
+    size_t size;
+    Entry() : size(0) { }
+  };
+  typedef std::map<packed_time, Entry> entries_t;
+
+  size_t sizeOf(const V& v) const
+    { return sizer_ ? sizer_(v) : sizeof(V); }
+
+  void insertLocked(packed_time t, value_ptr value);
+  void evictLocked();
+  void load(packed_time t, unsigned long generation, unsigned long epoch);
+
+private:
+  mutable std::mutex mutex_;
+  std::condition_variable loaded_;
+  const size_t budget_;
+  size_t used_;
+  packed_time cursor_;
+  unsigned long generation_; //!< bumped by prefetch, cancels loads not yet started
+  unsigned long epoch_;      //!< bumped by clear, drops loads still running
+  entries_t entries_;
+  std::set<packed_time> loading_;
+  const Loader loader_;
+  const SizeFunction sizer_;
+  WorkerPool worker_; // last member, so it stops before the rest is destroyed
+};
+
+// ------------------------------------------------------------------------
+
+template<class V>
+typename TimeCache<V>::value_ptr TimeCache<V>::get(packed_time t)
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (loading_.count(t))
+      loaded_.wait(lock);
+    typename entries_t::const_iterator it = entries_.find(t);
+    if (it != entries_.end())
+      return it->second.value;
+    loading_.insert(t);
+  }
+
+  value_ptr value;
+  try {
+    value = loader_(t);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    loading_.erase(t);
+    loaded_.notify_all();
+    throw;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  loading_.erase(t);
+  if (value)
+    insertLocked(t, value);
+  loaded_.notify_all();
+  return value;
+}
+
+template<class V>
+typename TimeCache<V>::value_ptr TimeCache<V>::find(packed_time t) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  typename entries_t::const_iterator it = entries_.find(t);
+  if (it != entries_.end())
+    return it->second.value;
+  return value_ptr();
+}
+
+template<class V>
+void TimeCache<V>::insert(packed_time t, value_ptr value)
+{
+  if (!value)
+    return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  insertLocked(t, value);
+}
+
+template<class V>
+void TimeCache<V>::setCursor(packed_time t)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  cursor_ = t;
+  evictLocked();
+}
+
+template<class V>
+void TimeCache<V>::prefetch(const std::vector<packed_time>& upcoming)
+{
+  worker_.clear();
+  unsigned long generation, epoch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation = ++generation_;
+    epoch = epoch_;
+  }
+  for (size_t i=0; i<upcoming.size(); ++i) {
+    const packed_time t = upcoming[i];
+    worker_.submit([this, t, generation, epoch]() { this->load(t, generation, epoch); });
+  }
+}
+
+template<class V>
+void TimeCache<V>::prefetch(const TimeAxis& axis, size_t n)
+{
+  std::vector<packed_time> upcoming;
+  const packed_time c = cursor();
+  for (size_t i=0; i<axis.size() && upcoming.size() < n; ++i) {
+    const packed_time t = axis.at(i);
+    if ((axis.step() >= 0) ? (t > c) : (t < c))
+      upcoming.push_back(t);
+  }
+  prefetch(upcoming);
+}
+
+template<class V>
+void TimeCache<V>::clear()
+{
+  worker_.clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  generation_ += 1;
+  epoch_ += 1;
+  entries_.clear();
+  used_ = 0;
+}
+
+template<class V>
+void TimeCache<V>::insertLocked(packed_time t, value_ptr value)
+{
+  Entry& e = entries_[t];
+  used_ -= e.size;
+  e.value = value;
+  e.size = sizeOf(*value);
+  used_ += e.size;
+  evictLocked();
+}
+
+template<class V>
+void TimeCache<V>::evictLocked()
+{
+  // the entry farthest from the cursor is always the first or the last one
+  while (used_ > budget_ && entries_.size() > 1) {
+    typename entries_t::iterator first = entries_.begin(), last = --entries_.end();
+    const bool evict_first = (cursor_ - first->first) >= (last->first - cursor_);
+    typename entries_t::iterator victim = evict_first ? first : last;
+    used_ -= victim->second.size;
+    entries_.erase(victim);
+  }
+}
+
+template<class V>
+void TimeCache<V>::load(packed_time t, unsigned long generation, unsigned long epoch)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (generation != generation_ || entries_.count(t) || loading_.count(t))
+      return;
+    loading_.insert(t);
+  }
+
+  value_ptr value;
+  try {
+    value = loader_(t);
+  } catch (...) {
+    // leave value empty
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  loading_.erase(t);
+  // a newer prefetch does not make a finished load useless, only clear() does
+  if (value && epoch == epoch_)
+    insertLocked(t, value);
+  loaded_.notify_all();
+}
+
+} // namespace miutil
+
+#endif // PUTOOLS_TIMECACHE_H
@@ -0,0 +1,442 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "TimeFiles.h"
+
+#include "miDirtools.h"
+#include "NameMatcher.h"
+#include "miStringFunctions.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace /*anonymous*/ {
+
+// below this many names, starting threads costs more than it saves
+const size_t PARALLEL_MIN_STATS = 1024;
+
+bool name_less(const miutil::TimeFile& a, const miutil::TimeFile& b)
+{
+  return a.name < b.name;
+}
+
+bool name_equal(const miutil::TimeFile& a, const miutil::TimeFile& b)
+{
+  return a.name == b.name;
+}
+
+bool time_less(const miutil::TimeFile& a, const miutil::TimeFile& b)
+{
+  if (a.time != b.time)
+    return a.time < b.time;
+  return a.name < b.name;
+}
+
+void stat_files(int dfd, const miutil::TimeFile* files, size_t count, char* exists)
+{
+  for (size_t i=0; i<count; ++i) {
+    struct stat st;
+    exists[i] = (fstatat(dfd, files[i].name.c_str(), &st, 0) == 0 && S_ISREG(st.st_mode));
+  }
+}
+
+enum { YEAR, MONTH, DAY, HOUR, MINUTE, SECOND, N_FIELDS };
+
+struct Fields {
+  int v[N_FIELDS];
+  Fields()
+    { std::fill(v, v + N_FIELDS, -1); }
+};
+
+struct Component {
+  std::string literal;       // if not timed
+  miutil::TimeFilter filter; // if timed
+  bool timed;
+  bool star;                 // timed pattern ends with '*'
+};
+
+bool component_matches(const Component& c, const char* name)
+{
+  if (!c.timed)
+    return c.literal == name;
+
+  const std::string& p = c.filter.pattern();
+  const size_t length = p.size() - (c.star ? 1 : 0);
+  size_t i = 0;
+  for (; i<length; ++i) {
+    const char ch = name[i];
+    if (ch == 0)
+      return false;
+    if (c.filter.isTimeField(i)) {
+      if (ch < '0' || ch > '9')
+        return false;
+    } else if (p[i] != '?' && p[i] != ch) {
+      return false;
+    }
+  }
+  return c.star || name[i] == 0;
+}
+
+/* Time span [begin, end] covered by the fields, using only the leading
+ * fields from the year down that are known. Returns false if the known
+ * fields are not a valid time.
+ */
+bool time_span(const Fields& f, miutil::packed_time& begin, miutil::packed_time& end)
+{
+  int n = 0;
+  while (n < N_FIELDS && f.v[n] >= 0)
+    n += 1;
+  if (n == 0) {
+    begin = std::numeric_limits<miutil::packed_time>::min();
+    end = std::numeric_limits<miutil::packed_time>::max();
+    return true;
+  }
+
+  const int y = f.v[YEAR];
+  const int m = (n > MONTH) ? f.v[MONTH] : 1;
+  const int d = (n > DAY) ? f.v[DAY] : 1;
+  const int H = (n > HOUR) ? f.v[HOUR] : 0;
+  const int M = (n > MINUTE) ? f.v[MINUTE] : 0;
+  const int S = (n > SECOND) ? f.v[SECOND] : 0;
+  if (!miutil::miDate::isValid(y, m, d) || d == 0 || !miutil::miClock::isValid(H, M, S))
+    return false;
+
+  begin = miutil::pack_time(y, m, d, H, M, S);
+  if (n == 1)
+    end = miutil::pack_time(y + 1, 1, 1, 0, 0, 0);
+  else if (n == 2)
+    end = (m == 12) ? miutil::pack_time(y + 1, 1, 1, 0, 0, 0) : miutil::pack_time(y, m + 1, 1, 0, 0, 0);
+  else if (n == 3)
+    end = begin + 86400;
+  else if (n == 4)
+    end = begin + 3600;
+  else if (n == 5)
+    end = begin + 60;
+  else
+    end = begin + 1;
+  end -= 1;
+  return true;
+}
+
+// time of a file, with defaults as TimeFilter::getTime
+bool file_time(Fields f, miutil::packed_time& t)
+{
+  if (f.v[YEAR] < 0 || f.v[MONTH] < 0 || f.v[DAY] < 0)
+    return false;
+  if (f.v[HOUR] < 0)
+    f.v[HOUR] = 12;
+  if (f.v[MINUTE] < 0)
+    f.v[MINUTE] = 0;
+  if (f.v[SECOND] < 0)
+    f.v[SECOND] = 0;
+  if (!miutil::miDate::isValid(f.v[YEAR], f.v[MONTH], f.v[DAY])
+      || !miutil::miClock::isValid(f.v[HOUR], f.v[MINUTE], f.v[SECOND]))
+    return false;
+  t = miutil::pack_time(f.v[YEAR], f.v[MONTH], f.v[DAY], f.v[HOUR], f.v[MINUTE], f.v[SECOND]);
+  return true;
+}
+
+struct TreeWalk {
+  std::vector<Component> components;
+  miutil::packed_time t1, t2;
+  std::vector<miutil::TimeFile>* files;
+
+  void walk(int dfd, const std::string& prefix, size_t level, const Fields& fields);
+  void entry(int dfd, const char* name, unsigned char type, const std::string& prefix,
+      size_t level, const Fields& fields);
+};
+
+// dfd is owned by walk and closed before it returns
+void TreeWalk::walk(int dfd, const std::string& prefix, size_t level, const Fields& fields)
+{
+  const Component& c = components[level];
+  if (!c.timed) {
+    entry(dfd, c.literal.c_str(), DT_UNKNOWN, prefix, level, fields);
+    ::close(dfd);
+    return;
+  }
+
+  DIR* dirp = fdopendir(dfd);
+  if (!dirp) {
+    ::close(dfd);
+    return;
+  }
+  while (dirent* dp = readdir(dirp)) {
+    if (component_matches(c, dp->d_name))
+      entry(dirfd(dirp), dp->d_name, dp->d_type, prefix, level, fields);
+  }
+  closedir(dirp);
+}
+
+void TreeWalk::entry(int dfd, const char* name, unsigned char type, const std::string& prefix,
+    size_t level, const Fields& fields)
+{
+  const Component& c = components[level];
+  Fields f = fields;
+  if (c.timed && !c.filter.getFields(name, f.v[YEAR], f.v[MONTH], f.v[DAY],
+          f.v[HOUR], f.v[MINUTE], f.v[SECOND]))
+    return;
+
+  if (level + 1 < components.size()) {
+    miutil::packed_time begin, end;
+    if (!time_span(f, begin, end) || end < t1 || begin > t2)
+      return;
+    if (type != DT_DIR && type != DT_UNKNOWN && type != DT_LNK)
+      return;
+    const int fd = openat(dfd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0)
+      walk(fd, prefix + name + "/", level + 1, f);
+  } else {
+    miutil::packed_time t;
+    if (!file_time(f, t) || t < t1 || t > t2)
+      return;
+    if (type != DT_REG) {
+      struct stat st;
+      if (fstatat(dfd, name, &st, 0) != 0 || !S_ISREG(st.st_mode))
+        return;
+    }
+    miutil::TimeFile tf;
+    tf.name = prefix + name;
+    tf.time = t;
+    files->push_back(tf);
+  }
+}
+
+// newest first, equal times by name
+bool newer(const miutil::TimeFile& a, const miutil::TimeFile& b)
+{
+  if (a.time != b.time)
+    return a.time > b.time;
+  return a.name < b.name;
+}
+
+/* Keeps the k newest of the files offered, in a heap with the oldest
+ * file kept on top, so each offer costs O(log k).
+ */
+class NewestHeap {
+public:
+  explicit NewestHeap(size_t k)
+    : k_(k) { heap_.reserve(k); }
+
+  void offer(const char* name, size_t length, miutil::packed_time t);
+
+  // the files, newest first; the heap is empty afterwards
+  void take(std::vector<miutil::TimeFile>& files);
+
+private:
+  size_t k_;
+  std::vector<miutil::TimeFile> heap_;
+};
+
+void NewestHeap::offer(const char* name, size_t length, miutil::packed_time t)
+{
+  if (heap_.size() < k_) {
+    heap_.push_back(miutil::TimeFile());
+    heap_.back().name.assign(name, length);
+    heap_.back().time = t;
+    std::push_heap(heap_.begin(), heap_.end(), newer);
+    return;
+  }
+  if (k_ == 0)
+    return;
+
+  // compare with the oldest before copying the name
+  const miutil::TimeFile& top = heap_.front();
+  if (t < top.time || (t == top.time && top.name.compare(0, std::string::npos, name, length) <= 0))
+    return;
+  std::pop_heap(heap_.begin(), heap_.end(), newer);
+  heap_.back().name.assign(name, length);
+  heap_.back().time = t;
+  std::push_heap(heap_.begin(), heap_.end(), newer);
+}
+
+void NewestHeap::take(std::vector<miutil::TimeFile>& files)
+{
+  std::sort_heap(heap_.begin(), heap_.end(), newer);
+  files.swap(heap_);
+  heap_.clear();
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+void make_time_names(const TimeFilter& filter, const std::vector<packed_time>& times,
+    std::vector<TimeFile>& files)
+{
+  files.clear();
+  files.reserve(times.size());
+  TimeFile f;
+  for (size_t i=0; i<times.size(); ++i) {
+    if (filter.makeName(times[i], f.name) && filter.getTime(f.name, f.time))
+      files.push_back(f);
+  }
+  std::sort(files.begin(), files.end(), name_less);
+  files.erase(std::unique(files.begin(), files.end(), name_equal), files.end());
+}
+
+bool find_time_files(const std::string& directory, const TimeFilter& filter,
+    const std::vector<packed_time>& times, std::vector<TimeFile>& files, size_t threads)
+{
+  files.clear();
+  const int dfd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dfd < 0)
+    return false;
+
+  std::vector<TimeFile> candidates;
+  make_time_names(filter, times, candidates);
+  const size_t count = candidates.size();
+  std::vector<char> exists(count, 0);
+
+  if (threads == 0)
+    threads = (count >= PARALLEL_MIN_STATS) ? std::thread::hardware_concurrency() : 1;
+  if (threads > count / 64 + 1)
+    threads = count / 64 + 1;
+
+  if (threads <= 1) {
+    if (count > 0)
+      stat_files(dfd, &candidates[0], count, &exists[0]);
+  } else {
+    std::vector<std::thread> workers;
+    const size_t chunk = (count + threads - 1) / threads;
+    for (size_t begin=0; begin<count; begin += chunk) {
+      const size_t n = std::min(chunk, count - begin);
+      workers.push_back(std::thread(stat_files, dfd, &candidates[begin], n, &exists[begin]));
+    }
+    for (size_t i=0; i<workers.size(); ++i)
+      workers[i].join();
+  }
+  ::close(dfd);
+
+  for (size_t i=0; i<count; ++i) {
+    if (exists[i])
+      files.push_back(candidates[i]);
+  }
+  std::sort(files.begin(), files.end(), time_less);
+  return true;
+}
+
+bool find_time_files(const std::string& directory, const TimeFilter& filter,
+    const TimeAxis& axis, std::vector<TimeFile>& files, size_t threads)
+{
+  return find_time_files(directory, filter, axis.times(), files, threads);
+}
+
+bool find_time_tree_files(const std::string& directory, const std::string& pattern,
+    packed_time t1, packed_time t2, std::vector<TimeFile>& files)
+{
+  files.clear();
+
+  TreeWalk tw;
+  const std::vector<std::string> parts = miutil::split(pattern, "/", true);
+  if (parts.empty())
+    return false;
+  for (size_t i=0; i<parts.size(); ++i) {
+    Component c;
+    c.timed = (parts[i].find('[') != std::string::npos);
+    c.star = false;
+    if (c.timed) {
+      std::string p = parts[i];
+      c.filter.initFilter(p);
+      if (!c.filter.hasFields())
+        return false;
+      c.star = (!p.empty() && p[p.size()-1] == '*');
+    } else {
+      c.literal = parts[i];
+    }
+    tw.components.push_back(c);
+  }
+  tw.t1 = t1;
+  tw.t2 = t2;
+  tw.files = &files;
+
+  const int dfd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dfd < 0)
+    return false;
+  tw.walk(dfd, std::string(), 0, Fields());
+
+  std::sort(files.begin(), files.end(), time_less);
+  return true;
+}
+
+bool find_newest_files(const std::string& directory, size_t k, NewestBy by,
+    const NameMatcher& matcher, std::vector<TimeFile>& files)
+{
+  files.clear();
+  if (!matcher.ok())
+    return false;
+
+  NewestHeap newest(k);
+  const bool ok = scan_directory_batches(directory, by == NEWEST_BY_CTIME ? SCAN_CTIME : SCAN_MTIME, matcher,
+      [&newest, by](const DirEntries& entries) {
+        for (size_t i=0; i<entries.size(); ++i) {
+          if (entries.type(i) != DirEntries::TYPE_DIR)
+            newest.offer(entries.name(i), entries.nameLength(i),
+                by == NEWEST_BY_CTIME ? entries.ctime(i) : entries.mtime(i));
+        }
+      });
+  if (ok)
+    newest.take(files);
+  return ok;
+}
+
+bool find_newest_files(const std::string& directory, size_t k, const TimeFilter& filter,
+    std::vector<TimeFile>& files)
+{
+  files.clear();
+  if (!filter.ok() || !filter.basenameOnly())
+    return false;
+
+  NewestHeap newest(k);
+  std::string name;
+  const bool ok = scan_directory_batches(directory, SCAN_TYPE, NameMatcher(),
+      [&newest, &filter, &name](const DirEntries& entries) {
+        for (size_t i=0; i<entries.size(); ++i) {
+          if (entries.type(i) == DirEntries::TYPE_DIR)
+            continue;
+          name.assign(entries.name(i), entries.nameLength(i));
+          packed_time t;
+          if (filter.getTime(name, t))
+            newest.offer(name.data(), name.size(), t);
+        }
+      });
+  if (ok)
+    newest.take(files);
+  return ok;
+}
+
+} // namespace miutil
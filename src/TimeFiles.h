@@ -0,0 +1,128 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_TIMEFILES_H
+#define PUTOOLS_TIMEFILES_H
+
+#include "TimeFilter.h"
+
+#include <string>
+#include <vector>
+
+namespace miutil {
+
+class NameMatcher;
+
+struct TimeFile {
+  std::string name;  //!< name relative to the directory
+  packed_time time;  //!< time read from the name, or mtime/ctime for find_newest_files
+};
+
+/*! Make the file names for the given times, sorted and without duplicates.
+ *
+ * Times that cannot be written with the filter are skipped, see
+ * TimeFilter::makeName. Several times give the same name if the pattern
+ * lacks some fields (e.g. no hour); the time read back from the name is
+ * reported, as getTime would do for a listed file.
+ */
+void make_time_names(const TimeFilter& filter, const std::vector<packed_time>& times,
+    std::vector<TimeFile>& files);
+
+/*! Find the existing files for the given times without reading the directory.
+ *
+ * The names are made with make_time_names and checked with one stat
+ * each, relative to the directory, so the cost depends on the number of
+ * times and not on the size of the directory.
+ *
+ * \param directory directory the pattern is relative to
+ * \param files set to the regular files found, sorted by time and name
+ * \param threads number of threads for stat'ing; 0 means threads are
+ *        only used for large batches
+ * \return false if the directory cannot be opened
+ */
+bool find_time_files(const std::string& directory, const TimeFilter& filter,
+    const std::vector<packed_time>& times, std::vector<TimeFile>& files, size_t threads=0);
+
+//! same as above, for all times on an axis
+bool find_time_files(const std::string& directory, const TimeFilter& filter,
+    const TimeAxis& axis, std::vector<TimeFile>& files, size_t threads=0);
+
+/*! Find files with times in [t1, t2] in a date-structured directory tree.
+ *
+ * The pattern is split at '/' and each component is a TimeFilter
+ * pattern of its own, which may have only some of the time fields, e.g.
+ * "[yyyy]/[mm]/[dd]/product_[yyyymmddHH].nc". Fields read from deeper
+ * components override those read from the directories above. A
+ * directory is only entered if the time span given by its fields and
+ * those above (e.g. one month for "2015/02") overlaps [t1, t2], so only
+ * the directories for the requested time range are read. Components
+ * without time fields must match exactly and are not listed.
+ *
+ * Within a component, '?' matches any character, time fields match
+ * digits and a '*' at the end matches any rest of the name. Files
+ * without hour get hour 12, as with TimeFilter::getTime.
+ *
+ * \param files set to the files found, with names relative to directory,
+ *        sorted by time and name
+ * \return false if the directory cannot be opened or a component is not
+ *         a valid pattern
+ */
+bool find_time_tree_files(const std::string& directory, const std::string& pattern,
+    packed_time t1, packed_time t2, std::vector<TimeFile>& files);
+
+enum NewestBy {
+  NEWEST_BY_MTIME,
+  NEWEST_BY_CTIME
+};
+
+/*! Find the k newest files in a directory.
+ *
+ * The directory is read in batches and only the k newest files seen so
+ * far are kept, so memory use depends on k and not on the size of the
+ * directory. Names not accepted by matcher are not stat'ed. Directories
+ * and files that cannot be stat'ed are left out.
+ *
+ * \param files set to at most k files, newest first and equal times by
+ *        name, with the modification or status change time
+ * \return false if the directory cannot be read
+ */
+bool find_newest_files(const std::string& directory, size_t k, NewestBy by,
+    const NameMatcher& matcher, std::vector<TimeFile>& files);
+
+/*! Find the k files with the newest time in their names.
+ *
+ * As above, but without stat'ing files; names without valid time are
+ * left out. The filter must be a pattern for basenames.
+ *
+ * \return false if the directory cannot be read or the filter has '/'
+ */
+bool find_newest_files(const std::string& directory, size_t k, const TimeFilter& filter,
+    std::vector<TimeFile>& files);
+
+} // namespace miutil
+
+#endif // PUTOOLS_TIMEFILES_H
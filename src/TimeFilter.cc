@@ -33,8 +33,12 @@
 
 #include "TimeFilter.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <stdexcept>
 #include <sstream>
+#include <thread>
 
 namespace /*anonymous*/ {
 bool assign_pos(std::string::size_type& pos, std::string::size_type new_pos)
@@ -45,6 +49,24 @@ bool assign_pos(std::string::size_type& pos, std::string::size_type new_pos)
   return true;
 }
 
+/* A group name is a plain identifier without a doubled field letter
+ * like "yy" or "HH", so that text with time fields before a ':' is
+ * never taken for a name.
+ */
+bool is_group_name(const std::string& prefix)
+{
+  if (prefix.empty() || !(isalpha(static_cast<unsigned char>(prefix[0])) || prefix[0] == '_'))
+    return false;
+  for (size_t i=0; i<prefix.size(); ++i) {
+    const char ch = prefix[i];
+    if (!(isalnum(static_cast<unsigned char>(ch)) || ch == '_'))
+      return false;
+    if (i > 0 && ch == prefix[i-1] && strchr("ymdHMS", ch))
+      return false;
+  }
+  return true;
+}
+
 std::string::size_type replace_first_if(std::string& s, const char* thys, int size)
 {
   const std::string::size_type idx = s.find(thys);
@@ -55,29 +77,55 @@ std::string::size_type replace_first_if(std::string& s, const char* thys, int si
   return idx;
 }
 
-void parse_time_int(const std::string& text, std::string::size_type idx, size_t count, std::string::size_type offset, int& value)
+bool parse_time_int(const std::string& text, std::string::size_type idx, size_t count, std::string::size_type offset, int& value)
 {
   if (idx == std::string::npos)
-    return;
+    return true;
 
   idx += offset;
 
   if (count < 1 || idx+count > text.size())
-    throw std::runtime_error("end of string");
+    return false;
 
-  value = 0;
+  int v = 0;
   for (size_t i=0; i<count; ++i, ++idx) {
-    char ch = text[idx];
+    const char ch = text[idx];
     if (ch < '0' || ch > '9')
-      throw std::runtime_error("no digit");
-    value = 10*value + (ch - '0');
+      return false;
+    v = 10*v + (ch - '0');
   }
+  value = v;
+  return true;
+}
+
+void put_time_int(std::string& text, std::string::size_type idx, size_t count, int value)
+{
+  if (idx == std::string::npos)
+    return;
+  for (size_t i=count; i>0; --i, value /= 10)
+    text[idx + i - 1] = '0' + (value % 10);
 }
+
+// below this number of names, a batch is not split across threads
+const size_t PARALLEL_MIN_NAMES = 16384;
 } /*anonymous namespace*/
 
 
 namespace miutil {
 
+TimeFilter::Group::Group(const std::string& n)
+  : name(n)
+  , yyyy(std::string::npos), yy(std::string::npos), mm(std::string::npos), dd(std::string::npos)
+  , HH(std::string::npos), MM(std::string::npos), SS(std::string::npos)
+{
+}
+
+bool TimeFilter::Group::ok() const
+{
+  return (dd != std::string::npos && mm != std::string::npos &&
+      (yy != std::string::npos || yyyy != std::string::npos));
+}
+
 TimeFilter::TimeFilter()
 {
   reset();
@@ -90,7 +138,11 @@ TimeFilter::TimeFilter(std::string& filename)
 
 void TimeFilter::reset()
 {
-  yyyy = yy = mm = dd = HH = MM = SS = std::string::npos;
+  groups_.clear();
+  lead = std::string::npos;
+  leadWidth = 0;
+  noSlash = true;
+  pattern_.clear();
 }
 
 bool TimeFilter::initFilter(std::string& filename)
@@ -109,6 +161,7 @@ bool TimeFilter::initFilter(std::string& filename)
 
   try {
     filename = parse(filename);
+    pattern_ = filename;
     return ok();
   } catch (std::exception& e) {
     reset();
@@ -118,8 +171,7 @@ bool TimeFilter::initFilter(std::string& filename)
 
 bool TimeFilter::ok() const
 {
-  return (dd != std::string::npos && mm != std::string::npos &&
-      (yy != std::string::npos || yyyy != std::string::npos));
+  return !groups_.empty() && groups_.front().ok();
 }
 
 
@@ -142,6 +194,25 @@ std::string TimeFilter::parse(const std::string& filename)
     pattern << filename.substr(pos, bracket_open - pos);
 
     size_t pat = bracket_open + 1;
+
+    // a group name is an identifier before ':'; brackets like
+    // "[yyyymmdd_HH:MM]" have a ':' between fields instead
+    std::string groupname;
+    const size_t colon = filename.find(':', pat);
+    if (colon < bracket_close) {
+      const std::string prefix = filename.substr(pat, colon - pat);
+      if (is_group_name(prefix)) {
+        groupname = prefix;
+        pat = colon + 1;
+      }
+    }
+    size_t g = 0;
+    while (g < groups_.size() && groups_[g].name != groupname)
+      g += 1;
+    if (g == groups_.size())
+      groups_.push_back(Group(groupname));
+    Group& group = groups_[g];
+
     while (pat < bracket_close) {
       const char pat0 = filename[pat];
       if (pat0 != 'y' && pat0 != 'm' && pat0 != 'd' && pat0 != 'H' && pat0 != 'M' && pat0 != 'S') {
@@ -156,22 +227,28 @@ std::string TimeFilter::parse(const std::string& filename)
 
       int n = 2;
       const size_t new_pos = pattern.tellp();
-      if (pat0 == 'm' && assign_pos(mm, new_pos)) {
+      size_t run = 2;
+      while (pat + run < bracket_close && filename[pat + run] == pat0)
+        run += 1;
+      if (pat0 == 'H' && run >= 3 && assign_pos(lead, new_pos)) {
+        leadWidth = run;
+        n = run;
+      } else if (pat0 == 'm' && assign_pos(group.mm, new_pos)) {
         // ok
-      } else if (pat0 == 'd' && assign_pos(dd, new_pos)) {
+      } else if (pat0 == 'd' && assign_pos(group.dd, new_pos)) {
         // ok
-      } else if (pat0 == 'H' && assign_pos(HH, new_pos)) {
+      } else if (pat0 == 'H' && run < 3 && assign_pos(group.HH, new_pos)) {
         // ok
-      } else if (pat0 == 'M' && assign_pos(MM, new_pos)) {
+      } else if (pat0 == 'M' && assign_pos(group.MM, new_pos)) {
         // ok
-      } else if (pat0 == 'S' && assign_pos(SS, new_pos)) {
+      } else if (pat0 == 'S' && assign_pos(group.SS, new_pos)) {
         // ok
-      } else if (pat0 == 'y' && yy == std::string::npos && yyyy == std::string::npos) {
+      } else if (pat0 == 'y' && group.yy == std::string::npos && group.yyyy == std::string::npos) {
         if (pat + 3 < bracket_close && filename[pat+2] == 'y' && filename[pat+3] == 'y') {
-          yyyy = new_pos;
+          group.yyyy = new_pos;
           n = 4;
         } else {
-          yy = new_pos;
+          group.yy = new_pos;
         }
       } else {
         throw std::runtime_error("pattern error");
@@ -185,52 +262,250 @@ std::string TimeFilter::parse(const std::string& filename)
   if (pos < filename.size())
     pattern << filename.substr(pos);
 
+  // drop groups from brackets with only a lead time or no fields at all
+  for (size_t g=groups_.size(); g>0; --g) {
+    const Group& gr = groups_[g-1];
+    if (gr.yyyy == std::string::npos && gr.yy == std::string::npos && gr.mm == std::string::npos
+        && gr.dd == std::string::npos && gr.HH == std::string::npos && gr.MM == std::string::npos
+        && gr.SS == std::string::npos)
+      groups_.erase(groups_.begin() + (g-1));
+  }
+
   return pattern.str();
 }
 
-bool TimeFilter::getTime(const std::string& name, miutil::miTime &time) const
+bool TimeFilter::hasFields() const
 {
-  if (!ok() || name.empty())
-    return false;
+  // parse drops groups without fields
+  return !groups_.empty() || hasLead();
+}
 
-  int offset = 0;
+std::string::size_type TimeFilter::nameOffset(const std::string& name) const
+{
   if (noSlash) {
     const std::string::size_type slash = name.find_last_of("/");
     if (slash != std::string::npos)
-      offset = slash + 1;
+      return slash + 1;
   }
+  return 0;
+}
 
-  try {
-    int year = 0, month, day, hour=12, minute = 0, second = 0;
-
-    parse_time_int(name, HH, 2, offset, hour);
-    parse_time_int(name, MM, 2, offset, minute);
-    parse_time_int(name, SS, 2, offset, second);
-
-    parse_time_int(name, dd, 2, offset, day);
-    parse_time_int(name, mm, 2, offset, month);
-
-    if (yyyy != std::string::npos) {
-      parse_time_int(name, yyyy, 4, offset, year);
-    } else {
-      parse_time_int(name, yy, 2, offset, year);
-      if (year > 50)
-        year += 1900;
-      else
-        year += 2000;
+bool TimeFilter::readGroup(const Group& g, const std::string& name, std::string::size_type offset,
+    int& year, int& month, int& day, int& hour, int& minute, int& second) const
+{
+  if (!(parse_time_int(name, g.HH, 2, offset, hour)
+          && parse_time_int(name, g.MM, 2, offset, minute)
+          && parse_time_int(name, g.SS, 2, offset, second)
+          && parse_time_int(name, g.dd, 2, offset, day)
+          && parse_time_int(name, g.mm, 2, offset, month)))
+    return false;
+
+  if (g.yyyy != std::string::npos) {
+    if (!parse_time_int(name, g.yyyy, 4, offset, year))
+      return false;
+  } else if (g.yy != std::string::npos) {
+    if (!parse_time_int(name, g.yy, 2, offset, year))
+      return false;
+    if (year > 50)
+      year += 1900;
+    else
+      year += 2000;
+  }
+  return true;
+}
+
+bool TimeFilter::getFields(const std::string& name, int& year, int& month, int& day,
+    int& hour, int& minute, int& second) const
+{
+  if (name.empty())
+    return false;
+  if (groups_.empty())
+    return true;
+  return readGroup(groups_.front(), name, nameOffset(name), year, month, day, hour, minute, second);
+}
+
+bool TimeFilter::extract(const Group& g, const std::string& name, std::string::size_type offset,
+    int& year, int& month, int& day, int& hour, int& minute, int& second) const
+{
+  if (!g.ok())
+    return false;
+
+  year = 0;
+  hour = 12;
+  minute = second = 0;
+
+  return readGroup(g, name, offset, year, month, day, hour, minute, second)
+      && miutil::miDate::isValid(year, month, day)
+      && miutil::miClock::isValid(hour, minute, second);
+}
+
+bool TimeFilter::readLead(const std::string& name, std::string::size_type offset, packed_time& seconds) const
+{
+  int hours = 0;
+  if (!parse_time_int(name, lead, leadWidth, offset, hours))
+    return false;
+  seconds = packed_time(hours) * 3600;
+  return true;
+}
+
+bool TimeFilter::getTime(const std::string& name, miutil::miTime &time) const
+{
+  int year, month, day, hour, minute, second;
+  if (!ok() || name.empty()
+      || !extract(groups_.front(), name, nameOffset(name), year, month, day, hour, minute, second))
+    return false;
+
+  miutil::miTime t(year, month, day, hour, minute, second);
+  if (t.undef())
+    return false;
+  std::swap(t, time);
+  return true;
+}
+
+bool TimeFilter::getTime(const std::string& name, packed_time& time) const
+{
+  return ok() && getGroupTime(name, 0, time);
+}
+
+int TimeFilter::group(const std::string& groupname) const
+{
+  for (size_t g=0; g<groups_.size(); ++g) {
+    if (groups_[g].name == groupname)
+      return g;
+  }
+  return -1;
+}
+
+bool TimeFilter::getGroupTime(const std::string& name, size_t group, packed_time& time) const
+{
+  int year, month, day, hour, minute, second;
+  if (group >= groups_.size() || name.empty()
+      || !extract(groups_[group], name, nameOffset(name), year, month, day, hour, minute, second))
+    return false;
+  time = pack_time(year, month, day, hour, minute, second);
+  return true;
+}
+
+bool TimeFilter::getGroupTimes(const std::string& name, packed_time* times, packed_time& leadtime) const
+{
+  if (!ok() || name.empty())
+    return false;
+  const std::string::size_type offset = nameOffset(name);
+  int year, month, day, hour, minute, second;
+  for (size_t g=0; g<groups_.size(); ++g) {
+    if (!extract(groups_[g], name, offset, year, month, day, hour, minute, second))
+      return false;
+    times[g] = pack_time(year, month, day, hour, minute, second);
+  }
+  leadtime = 0;
+  return readLead(name, offset, leadtime);
+}
+
+bool TimeFilter::getValidTime(const std::string& name, packed_time& time) const
+{
+  int year, month, day, hour, minute, second;
+  const std::string::size_type offset = nameOffset(name);
+  packed_time leadtime = 0;
+  if (!ok() || name.empty()
+      || !extract(groups_.front(), name, offset, year, month, day, hour, minute, second)
+      || !readLead(name, offset, leadtime))
+    return false;
+  time = pack_time(year, month, day, hour, minute, second) + leadtime;
+  return true;
+}
+
+void TimeFilter::getTimes(const std::string* names, size_t count, packed_time* times) const
+{
+  for (size_t i=0; i<count; ++i) {
+    if (!getTime(names[i], times[i]))
+      times[i] = PACKED_TIME_UNDEF;
+  }
+}
+
+size_t TimeFilter::getTimes(const std::vector<std::string>& names,
+    std::vector<packed_time>& times, std::vector<bool>& matched, size_t threads) const
+{
+  const size_t count = names.size();
+  times.resize(count);
+  matched.assign(count, false);
+  if (count == 0 || !ok())
+    return 0;
+
+  if (threads == 0)
+    threads = (count >= PARALLEL_MIN_NAMES) ? std::thread::hardware_concurrency() : 1;
+  if (threads > count / 1024 + 1)
+    threads = count / 1024 + 1;
+
+  if (threads <= 1) {
+    getTimes(&names[0], count, &times[0]);
+  } else {
+    // each thread writes its own slice of times; the bitmap is filled
+    // afterwards as neighbouring bits share a word
+    std::vector<std::thread> workers;
+    const size_t chunk = (count + threads - 1) / threads;
+    for (size_t begin=0; begin<count; begin += chunk) {
+      const size_t n = std::min(chunk, count - begin);
+      const std::string* slice_names = &names[begin];
+      packed_time* slice_times = &times[begin];
+      workers.push_back(std::thread([this, slice_names, n, slice_times]() {
+            this->getTimes(slice_names, n, slice_times);
+          }));
     }
+    for (size_t i=0; i<workers.size(); ++i)
+      workers[i].join();
+  }
 
-    miutil::miTime t(year, month, day, hour, minute, second);
-    if (!t.undef()) {
-      std::swap(t, time);
-      return true;
+  size_t n_matched = 0;
+  for (size_t i=0; i<count; ++i) {
+    if (times[i] != PACKED_TIME_UNDEF) {
+      matched[i] = true;
+      n_matched += 1;
+    }
+  }
+  return n_matched;
+}
+
+bool TimeFilter::isTimeField(std::string::size_type pos) const
+{
+  if (lead != std::string::npos && pos >= lead && pos < lead + leadWidth)
+    return true;
+  for (size_t g=0; g<groups_.size(); ++g) {
+    const Group& gr = groups_[g];
+    const std::string::size_type starts[7] = { gr.yyyy, gr.yy, gr.mm, gr.dd, gr.HH, gr.MM, gr.SS };
+    const std::string::size_type widths[7] = { 4,       2,     2,     2,     2,     2,     2 };
+    for (int i=0; i<7; ++i) {
+      if (starts[i] != std::string::npos && pos >= starts[i] && pos < starts[i] + widths[i])
+        return true;
     }
-  } catch (std::exception& e) {
-    // nothing
   }
   return false;
 }
 
+bool TimeFilter::makeName(packed_time t, std::string& name) const
+{
+  if (!ok() || t == PACKED_TIME_UNDEF)
+    return false;
+
+  const Group& g = groups_.front();
+  const miutil::miTime mt = unpack_time(t);
+  const int year = mt.year();
+  if (g.yy != std::string::npos && (year <= 1950 || year > 2050))
+    return false; // would be read back as another century
+  if (year < 0 || year > 9999)
+    return false;
+
+  name = pattern_;
+  put_time_int(name, g.yyyy, 4, year);
+  put_time_int(name, g.yy, 2, year % 100);
+  put_time_int(name, g.mm, 2, mt.month());
+  put_time_int(name, g.dd, 2, mt.day());
+  put_time_int(name, g.HH, 2, mt.hour());
+  put_time_int(name, g.MM, 2, mt.min());
+  put_time_int(name, g.SS, 2, mt.sec());
+  // other groups and the lead time are still '?'
+  return name.find_first_of("?*") == std::string::npos;
+}
+
 std::string TimeFilter::getTimeStr(const std::string& filename) const
 {
   if (ok()) {
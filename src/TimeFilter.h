@@ -31,11 +31,23 @@
 #define TimeFilter_h
 
 #include "miTime.h"
+#include "PackedTime.h"
+
+#include <vector>
 
 namespace miutil {
 
 /**
   \brief get time info from file name
+
+  Time fields are given in brackets, e.g. "ec_[yyyymmddHH].grb". A bracket
+  may start with a group name and ':', e.g. "[ref:yyyymmddHH]", to read
+  several times from one name; a name is an identifier without doubled
+  field letters, so "[yyyymmdd_HH:MM]" is all fields. Brackets with the
+  same name (or none) belong to the same group. getTime reads the first
+  group in the pattern. A run of three or more 'H' in a bracket, e.g.
+  "+[HHH]", is a lead time in hours, added to the first group's time by
+  getValidTime.
 */
 class TimeFilter {
 public:
@@ -50,17 +62,115 @@ public:
   /// returns true if initFilter found timeinfo in filename
   bool ok() const;
 
+  /// true if initFilter found any time field, maybe too few for ok()
+  bool hasFields() const;
+
   /// find time from filename
   bool getTime(const std::string& name, miutil::miTime& t) const;
 
+  /// find time from filename, same as above but as packed time
+  bool getTime(const std::string& name, packed_time& t) const;
+
+  /*! find times for many file names
+   *
+   * Names without time are set to PACKED_TIME_UNDEF.
+   */
+  void getTimes(const std::string* names, size_t count, packed_time* times) const;
+
+  /*! find times for many file names, possibly using several threads
+   *
+   * \param times set to the time for each name, PACKED_TIME_UNDEF if none
+   * \param matched set to true for each name with time
+   * \param threads number of threads; 0 means threads are only used for
+   *        large batches
+   * \return number of names with time
+   */
+  size_t getTimes(const std::vector<std::string>& names, std::vector<packed_time>& times,
+      std::vector<bool>& matched, size_t threads=0) const;
+
   std::string getTimeStr(const std::string& name) const;
 
+  /// pattern with time info replaced by '?'s, as returned by initFilter
+  const std::string& pattern() const
+    { return pattern_; }
+
+  /// true if the pattern has no '/' and is matched against basenames only
+  bool basenameOnly() const
+    { return noSlash; }
+
+  /// true if position pos in pattern() belongs to a time field
+  bool isTimeField(std::string::size_type pos) const;
+
+  /*! read only the time fields that are in the pattern
+   *
+   * Unlike getTime, this also works for patterns with too few fields
+   * for ok(), e.g. a directory named "[yyyy]". Fields not in the pattern
+   * are left unchanged; two-digit years are converted as by getTime.
+   * Values are not checked for validity.
+   */
+  bool getFields(const std::string& name, int& year, int& month, int& day,
+      int& hour, int& minute, int& second) const;
+
+  /*! make the file name for time t, the reverse of getTime
+   *
+   * Fails if the pattern has other wildcards than the time fields, or if
+   * the year does not fit a two-digit year field. Patterns with several
+   * groups or a lead time cannot be reversed.
+   */
+  bool makeName(packed_time t, std::string& name) const;
+
+  /// number of time groups, in order of first appearance in the pattern
+  size_t groupCount() const
+    { return groups_.size(); }
+
+  /// index of the group with this name ("" for brackets without name), or -1
+  int group(const std::string& groupname) const;
+
+  /// find the time of one group from filename
+  bool getGroupTime(const std::string& name, size_t group, packed_time& t) const;
+
+  /*! find the times of all groups and the lead time in one pass
+   *
+   * \param times set to the time of each group, groupCount() elements
+   * \param lead set to the lead time in seconds, 0 without lead field
+   * \return false unless all groups have a valid time
+   */
+  bool getGroupTimes(const std::string& name, packed_time* times, packed_time& lead) const;
+
+  /// true if the pattern has a lead time field
+  bool hasLead() const
+    { return lead != std::string::npos; }
+
+  /// find the first group's time plus the lead time
+  bool getValidTime(const std::string& name, packed_time& t) const;
+
 private:
   std::string parse(const std::string& filename);
 
+  struct Group {
+    std::string name;
+    std::string::size_type yyyy,yy,mm,dd,HH,MM,SS;
+
+    explicit Group(const std::string& n);
+    bool ok() const;
+  };
+
+  std::string::size_type nameOffset(const std::string& name) const;
+
+  bool readGroup(const Group& g, const std::string& name, std::string::size_type offset,
+      int& year, int& month, int& day, int& hour, int& minute, int& second) const;
+
+  bool extract(const Group& g, const std::string& name, std::string::size_type offset,
+      int& year, int& month, int& day, int& hour, int& minute, int& second) const;
+
+  bool readLead(const std::string& name, std::string::size_type offset, packed_time& seconds) const;
+
 private:
-  std::string::size_type yyyy,yy,mm,dd,HH,MM,SS;
+  std::vector<Group> groups_;
+  std::string::size_type lead;
+  size_t leadWidth;
   bool noSlash;
+  std::string pattern_;
 };
 
 } // namespace miutil
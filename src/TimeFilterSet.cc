@@ -0,0 +1,363 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "TimeFilterSet.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+
+namespace /*anonymous*/ {
+
+// above this, compile() gives up and patterns are tried one by one
+const size_t MAX_STATES = 65536;
+
+enum { CLASS_OTHER = 0, CLASS_DIGIT = 1 };
+
+// what a pattern accepts at one position
+struct Position {
+  enum Kind { LITERAL, DIGIT, ANY } kind;
+  unsigned char ch;
+};
+
+inline bool is_digit(unsigned char ch)
+{
+  return ch >= '0' && ch <= '9';
+}
+
+size_t pattern_length(const miutil::TimeFilter& f, bool star)
+{
+  return f.pattern().size() - (star ? 1 : 0);
+}
+
+Position position(const miutil::TimeFilter& f, size_t pos)
+{
+  Position p;
+  p.ch = f.pattern()[pos];
+  if (f.isTimeField(pos))
+    p.kind = Position::DIGIT;
+  else if (p.ch == '?')
+    p.kind = Position::ANY;
+  else
+    p.kind = Position::LITERAL;
+  return p;
+}
+
+inline bool accepts(const Position& p, unsigned char ch)
+{
+  if (p.kind == Position::ANY)
+    return true;
+  if (p.kind == Position::DIGIT)
+    return is_digit(ch);
+  return p.ch == ch;
+}
+
+inline std::string::size_type subject_offset(const miutil::TimeFilter& f, const std::string& name)
+{
+  if (!f.basenameOnly())
+    return 0;
+  const std::string::size_type slash = name.find_last_of('/');
+  return (slash == std::string::npos) ? 0 : slash + 1;
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+TimeFilterSet::TimeFilterSet()
+  : compiled_(0)
+{
+}
+
+int TimeFilterSet::add(const std::string& pattern)
+{
+  std::string p(pattern);
+  TimeFilter f;
+  if (!f.initFilter(p))
+    return -1;
+  const std::string& fp = f.pattern();
+  filters_.push_back(f);
+  star_.push_back(!fp.empty() && fp[fp.size()-1] == '*');
+  return filters_.size() - 1;
+}
+
+void TimeFilterSet::clear()
+{
+  filters_.clear();
+  star_.clear();
+  compiled_ = 0;
+  basename_.clear();
+  path_.clear();
+}
+
+void TimeFilterSet::compile()
+{
+  basename_.clear();
+  path_.clear();
+  for (size_t i=0; i<filters_.size(); ++i) {
+    if (filters_[i].basenameOnly())
+      basename_.patterns.push_back(i);
+    else
+      path_.patterns.push_back(i);
+  }
+  basename_.build(filters_, star_);
+  path_.build(filters_, star_);
+  compiled_ = filters_.size();
+}
+
+void TimeFilterSet::Automaton::clear()
+{
+  patterns.clear();
+  transitions.clear();
+  accept.clear();
+  n_classes = 0;
+  compiled = false;
+}
+
+/* Subset construction over the patterns. A state is the set of patterns
+ * still matching after some number of characters (the depth, capped at
+ * the longest pattern since only '*' patterns can go beyond). Bytes are
+ * first mapped to classes: one class per byte used as a literal, one for
+ * other digits and one for everything else.
+ */
+void TimeFilterSet::Automaton::build(const std::vector<TimeFilter>& filters, const std::vector<bool>& star)
+{
+  compiled = false;
+  transitions.clear();
+  accept.clear();
+
+  const size_t n_patterns = patterns.size();
+  if (n_patterns == 0)
+    return;
+
+  std::vector<std::vector<Position> > positions(n_patterns);
+  std::vector<bool> stars(n_patterns);
+  size_t max_length = 0;
+  for (size_t k=0; k<n_patterns; ++k) {
+    const TimeFilter& f = filters[patterns[k]];
+    stars[k] = star[patterns[k]];
+    const size_t length = pattern_length(f, stars[k]);
+    for (size_t p=0; p<length; ++p)
+      positions[k].push_back(position(f, p));
+    max_length = std::max(max_length, length);
+  }
+
+  // byte classes
+  int class_byte[256]; // representative byte of a literal class, or -1
+  for (int b=0; b<256; ++b) {
+    classes[b] = is_digit(b) ? CLASS_DIGIT : CLASS_OTHER;
+    class_byte[b] = -1;
+  }
+  n_classes = 2;
+  for (size_t k=0; k<n_patterns; ++k) {
+    for (size_t p=0; p<positions[k].size(); ++p) {
+      const Position& pos = positions[k][p];
+      if (pos.kind == Position::LITERAL && class_byte[pos.ch] < 0) {
+        class_byte[pos.ch] = pos.ch;
+        classes[pos.ch] = n_classes++;
+      }
+    }
+  }
+  // any byte of the class; literals only compare equal to their own class
+  std::vector<unsigned char> representative(n_classes);
+  representative[CLASS_OTHER] = 0;
+  representative[CLASS_DIGIT] = '0';
+  for (int b=0; b<256; ++b)
+    if (class_byte[b] >= 0)
+      representative[classes[b]] = b;
+
+  const size_t n_words = (n_patterns + 63) / 64;
+  typedef std::vector<uint64_t> alive_t;
+  typedef std::pair<size_t, alive_t> key_t;
+  std::map<key_t, int> state_ids;
+  std::vector<key_t> states;
+
+  alive_t all(n_words, 0);
+  for (size_t k=0; k<n_patterns; ++k)
+    all[k / 64] |= uint64_t(1) << (k % 64);
+  states.push_back(key_t(0, all));
+  state_ids[states.back()] = 0;
+
+  for (size_t s=0; s<states.size(); ++s) {
+    const size_t depth = states[s].first;
+    const alive_t alive = states[s].second;
+
+    std::vector<size_t> acc;
+    for (size_t k=0; k<n_patterns; ++k) {
+      if ((alive[k / 64] >> (k % 64)) & 1) {
+        const size_t length = positions[k].size();
+        if (depth == length || (stars[k] && depth >= length))
+          acc.push_back(patterns[k]);
+      }
+    }
+    accept.push_back(acc);
+
+    for (size_t c=0; c<n_classes; ++c) {
+      alive_t next(n_words, 0);
+      bool any = false;
+      for (size_t k=0; k<n_patterns; ++k) {
+        if (!((alive[k / 64] >> (k % 64)) & 1))
+          continue;
+        bool ok;
+        if (depth < positions[k].size()) {
+          const Position& pos = positions[k][depth];
+          ok = (pos.kind != Position::LITERAL || c > CLASS_DIGIT)
+              && accepts(pos, representative[c]);
+        } else {
+          ok = stars[k];
+        }
+        if (ok) {
+          next[k / 64] |= uint64_t(1) << (k % 64);
+          any = true;
+        }
+      }
+      int id = -1;
+      if (any) {
+        const key_t key(std::min(depth + 1, max_length), next);
+        std::map<key_t, int>::const_iterator it = state_ids.find(key);
+        if (it != state_ids.end()) {
+          id = it->second;
+        } else {
+          if (states.size() >= MAX_STATES) {
+            transitions.clear();
+            accept.clear();
+            return;
+          }
+          id = states.size();
+          states.push_back(key);
+          state_ids[key] = id;
+        }
+      }
+      transitions.push_back(id);
+    }
+  }
+  compiled = true;
+}
+
+bool TimeFilterSet::matches(size_t index, const std::string& name) const
+{
+  const TimeFilter& f = filters_[index];
+  const std::string::size_type offset = subject_offset(f, name);
+  const size_t length = pattern_length(f, star_[index]);
+  const size_t subject_length = name.size() - offset;
+  if (subject_length < length || (subject_length > length && !star_[index]))
+    return false;
+  for (size_t p=0; p<length; ++p) {
+    if (!accepts(position(f, p), name[offset + p]))
+      return false;
+  }
+  return true;
+}
+
+int TimeFilterSet::match(const std::string& name, packed_time& t) const
+{
+  // candidates come from the automata, or from the patterns one by one if
+  // an automaton could not be built; each list is in pattern order, so it
+  // is left at the first valid time, and nothing is collected per name
+  int best = -1;
+  packed_time best_time = PACKED_TIME_UNDEF;
+  const auto valid = [&](size_t index) {
+    packed_time pt;
+    if (!filters_[index].getTime(name, pt))
+      return false;
+    best = index;
+    best_time = pt;
+    return true;
+  };
+
+  const Automaton* automata[2] = { &basename_, &path_ };
+  for (int a=0; a<2; ++a) {
+    const Automaton& am = *automata[a];
+    if (am.patterns.empty())
+      continue;
+    if (!am.compiled) {
+      for (size_t k=0; k<am.patterns.size(); ++k) {
+        const size_t index = am.patterns[k];
+        if (best >= 0 && index >= size_t(best))
+          break;
+        if (matches(index, name) && valid(index))
+          break;
+      }
+      continue;
+    }
+
+    size_t offset = 0;
+    if (a == 0) {
+      const std::string::size_type slash = name.find_last_of('/');
+      if (slash != std::string::npos)
+        offset = slash + 1;
+    }
+    int state = 0;
+    for (size_t i=offset; i<name.size() && state >= 0; ++i)
+      state = am.transitions[state * am.n_classes + am.classes[static_cast<unsigned char>(name[i])]];
+    if (state < 0)
+      continue;
+    const std::vector<size_t>& accepted = am.accept[state];
+    for (size_t k=0; k<accepted.size(); ++k) {
+      if (best >= 0 && accepted[k] >= size_t(best))
+        break;
+      if (valid(accepted[k]))
+        break;
+    }
+  }
+
+  // patterns added after compile() come after all others
+  for (size_t i=compiled_; i<filters_.size() && best < 0; ++i)
+    if (matches(i, name))
+      valid(i);
+
+  if (best >= 0)
+    t = best_time;
+  return best;
+}
+
+int TimeFilterSet::match(const std::string& name, miutil::miTime& t) const
+{
+  packed_time p;
+  const int index = match(name, p);
+  if (index >= 0)
+    t = unpack_time(p);
+  return index;
+}
+
+void TimeFilterSet::match(const std::vector<std::string>& names, std::vector<int>& indices,
+    std::vector<packed_time>& times) const
+{
+  indices.resize(names.size());
+  times.resize(names.size());
+  for (size_t i=0; i<names.size(); ++i) {
+    indices[i] = match(names[i], times[i]);
+    if (indices[i] < 0)
+      times[i] = PACKED_TIME_UNDEF;
+  }
+}
+
+} // namespace miutil
@@ -0,0 +1,103 @@
+// -*- c++ -*-
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef TimeFilterSet_h
+#define TimeFilterSet_h
+
+#include "TimeFilter.h"
+
+namespace miutil {
+
+/**
+  \brief classify file names against many TimeFilter patterns at once
+
+  Unlike TimeFilter::getTime, a name only matches a pattern if it has
+  the same length and all literal characters are equal; '?' in the
+  pattern matches any character, time fields match digits only, and a
+  '*' at the end of the pattern matches any rest of the name. Patterns
+  without '/' are matched against the basename.
+
+  compile() builds one deterministic automaton per kind of pattern
+  (basename or full path), so each name is read only once, however many
+  patterns there are. Patterns added later are tried one by one until
+  compile() is called again.
+*/
+class TimeFilterSet {
+public:
+  TimeFilterSet();
+
+  /// add a bracket pattern; returns its index, or -1 if it has no valid time info
+  int add(const std::string& pattern);
+
+  size_t size() const
+    { return filters_.size(); }
+
+  const TimeFilter& filter(size_t index) const
+    { return filters_[index]; }
+
+  void clear();
+
+  /// build the automata for all patterns added so far
+  void compile();
+
+  /// index of the first pattern matching name with a valid time, or -1
+  int match(const std::string& name, packed_time& t) const;
+
+  int match(const std::string& name, miutil::miTime& t) const;
+
+  /// match many names; index -1 and PACKED_TIME_UNDEF where none matches
+  void match(const std::vector<std::string>& names, std::vector<int>& indices,
+      std::vector<packed_time>& times) const;
+
+private:
+  struct Automaton {
+    std::vector<size_t> patterns;          // indices into filters_, in priority order
+    unsigned char classes[256];            // byte -> character class
+    size_t n_classes;
+    std::vector<int> transitions;          // state * n_classes + class -> state, -1 = no match
+    std::vector<std::vector<size_t> > accept; // per state, patterns matching at end of name
+    bool compiled;
+
+    Automaton() : n_classes(0), compiled(false) { }
+    void build(const std::vector<TimeFilter>& filters, const std::vector<bool>& star);
+    void clear();
+  };
+
+  /// match without automaton, for patterns added after compile()
+  bool matches(size_t index, const std::string& name) const;
+
+private:
+  std::vector<TimeFilter> filters_;
+  std::vector<bool> star_;      // pattern ends with '*'
+  size_t compiled_;             // number of patterns in the automata
+  Automaton basename_, path_;
+};
+
+} // namespace miutil
+
+#endif // TimeFilterSet_h
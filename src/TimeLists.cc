@@ -0,0 +1,290 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "TimeLists.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace /*anonymous*/ {
+
+using miutil::packed_time;
+using miutil::time_list_ptrs;
+
+typedef std::pair<packed_time, size_t> head_t; // (time, list index)
+typedef std::priority_queue<head_t, std::vector<head_t>, std::greater<head_t> > heap_t;
+
+/* Streams the k lists in ascending order using a binary heap of list
+ * heads; calls f(time, list index) for each element.
+ */
+template<class F>
+void kway(const time_list_ptrs& lists, F& f)
+{
+  std::vector<size_t> pos(lists.size(), 0);
+  heap_t heap;
+  for (size_t l=0; l<lists.size(); ++l) {
+    if (lists[l] && !lists[l]->empty())
+      heap.push(head_t(lists[l]->front(), l));
+  }
+  while (!heap.empty()) {
+    const head_t h = heap.top();
+    heap.pop();
+    f(h.first, h.second);
+    const std::vector<packed_time>& list = *lists[h.second];
+    size_t& p = pos[h.second];
+    p += 1;
+    if (p < list.size())
+      heap.push(head_t(list[p], h.second));
+  }
+}
+
+struct Append {
+  std::vector<packed_time>& out;
+  Append(std::vector<packed_time>& o) : out(o) { }
+  void operator()(packed_time t, size_t)
+    { out.push_back(t); }
+};
+
+// groups times within tolerance of the group start
+struct Grouper {
+  std::vector<packed_time>& out;
+  const packed_time tolerance;
+  const size_t needed; // number of lists that must contribute to a group
+  std::vector<size_t> last_group; // per list, last group it contributed to
+  size_t group, count;
+  packed_time start;
+  bool open;
+
+  Grouper(std::vector<packed_time>& o, packed_time tol, size_t n_lists, bool all)
+    : out(o), tolerance(tol), needed(all ? n_lists : 1)
+    , last_group(n_lists, 0), group(0), count(0), start(0), open(false) { }
+
+  void operator()(packed_time t, size_t l)
+    {
+      if (!open || t - start > tolerance) {
+        finish();
+        group += 1;
+        count = 0;
+        start = t;
+        open = true;
+      }
+      if (last_group[l] != group) {
+        last_group[l] = group;
+        count += 1;
+      }
+    }
+
+  void finish()
+    {
+      if (open && count >= needed)
+        out.push_back(start);
+      open = false;
+    }
+};
+
+packed_time gcd(packed_time a, packed_time b)
+{
+  while (b != 0) {
+    const packed_time r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+size_t total_size(const time_list_ptrs& lists)
+{
+  size_t n = 0;
+  for (size_t l=0; l<lists.size(); ++l)
+    if (lists[l])
+      n += lists[l]->size();
+  return n;
+}
+
+typedef std::vector<uint64_t> bits_t;
+
+void set_bits(const std::vector<packed_time>& list, const miutil::TimeAxis& axis, bits_t& bits)
+{
+  for (size_t i=0; i<list.size(); ++i) {
+    size_t idx = 0;
+    axis.index(list[i], idx);
+    bits[idx / 64] |= (uint64_t(1) << (idx % 64));
+  }
+}
+
+void bits_to_times(const bits_t& bits, const miutil::TimeAxis& axis, std::vector<packed_time>& out)
+{
+  for (size_t w=0; w<bits.size(); ++w) {
+    uint64_t word = bits[w];
+    while (word) {
+      const int b = __builtin_ctzll(word);
+      out.push_back(axis.at(w*64 + b));
+      word &= word - 1;
+    }
+  }
+}
+
+/* If all times lie on a common regular axis that is not much longer
+ * than the input, set operations can be done on bitsets instead of
+ * merging. With tolerance >= step, neighbouring axis points could merge
+ * into one group, so the bitset path is not used then.
+ */
+bool use_bitsets(const time_list_ptrs& lists, packed_time tolerance, miutil::TimeAxis& axis)
+{
+  if (lists.size() < 2 || !miutil::common_time_axis(lists, axis))
+    return false;
+  if (axis.size() > 1 && tolerance >= axis.step())
+    return false;
+  return axis.size() <= 8 * total_size(lists) + 256;
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+bool common_time_axis(const time_list_ptrs& lists, TimeAxis& axis)
+{
+  bool found = false;
+  packed_time first = 0, last = 0;
+  for (size_t l=0; l<lists.size(); ++l) {
+    if (!lists[l] || lists[l]->empty())
+      continue;
+    const packed_time f = lists[l]->front(), b = lists[l]->back();
+    if (!found || f < first)
+      first = f;
+    if (!found || b > last)
+      last = b;
+    found = true;
+  }
+  if (!found)
+    return false;
+
+  packed_time step = 0;
+  for (size_t l=0; l<lists.size() && step != 1; ++l) {
+    if (!lists[l])
+      continue;
+    const std::vector<packed_time>& list = *lists[l];
+    for (size_t i=0; i<list.size() && step != 1; ++i)
+      step = gcd(list[i] - first, step);
+  }
+  if (step == 0)
+    axis = TimeAxis(first, 1, 1);
+  else
+    axis = TimeAxis(first, step, (last - first) / step + 1);
+  return true;
+}
+
+void merge_times(const time_list_ptrs& lists, std::vector<packed_time>& merged)
+{
+  merged.clear();
+  merged.reserve(total_size(lists));
+  Append a(merged);
+  kway(lists, a);
+}
+
+void union_times(const time_list_ptrs& lists, std::vector<packed_time>& result,
+    packed_time tolerance)
+{
+  result.clear();
+  TimeAxis axis;
+  if (use_bitsets(lists, tolerance, axis)) {
+    bits_t bits((axis.size() + 63) / 64, 0);
+    for (size_t l=0; l<lists.size(); ++l)
+      if (lists[l])
+        set_bits(*lists[l], axis, bits);
+    bits_to_times(bits, axis, result);
+    return;
+  }
+
+  Grouper g(result, tolerance, lists.size(), false);
+  kway(lists, g);
+  g.finish();
+}
+
+void intersect_times(const time_list_ptrs& lists, std::vector<packed_time>& result,
+    packed_time tolerance)
+{
+  result.clear();
+  for (size_t l=0; l<lists.size(); ++l)
+    if (!lists[l] || lists[l]->empty())
+      return;
+
+  TimeAxis axis;
+  if (use_bitsets(lists, tolerance, axis)) {
+    const size_t n_words = (axis.size() + 63) / 64;
+    bits_t acc(n_words, 0), bits(n_words);
+    set_bits(*lists[0], axis, acc);
+    for (size_t l=1; l<lists.size(); ++l) {
+      std::fill(bits.begin(), bits.end(), 0);
+      set_bits(*lists[l], axis, bits);
+      for (size_t w=0; w<n_words; ++w)
+        acc[w] &= bits[w];
+    }
+    bits_to_times(acc, axis, result);
+    return;
+  }
+
+  Grouper g(result, tolerance, lists.size(), true);
+  kway(lists, g);
+  g.finish();
+}
+
+// ------------------------------------------------------------------------
+
+namespace {
+time_list_ptrs pointers(const std::vector<std::vector<packed_time> >& lists)
+{
+  time_list_ptrs p(lists.size());
+  for (size_t l=0; l<lists.size(); ++l)
+    p[l] = &lists[l];
+  return p;
+}
+} // namespace
+
+void merge_times(const std::vector<std::vector<packed_time> >& lists, std::vector<packed_time>& merged)
+{
+  merge_times(pointers(lists), merged);
+}
+
+void union_times(const std::vector<std::vector<packed_time> >& lists, std::vector<packed_time>& result,
+    packed_time tolerance)
+{
+  union_times(pointers(lists), result, tolerance);
+}
+
+void intersect_times(const std::vector<std::vector<packed_time> >& lists, std::vector<packed_time>& result,
+    packed_time tolerance)
+{
+  intersect_times(pointers(lists), result, tolerance);
+}
+
+} // namespace miutil
@@ -0,0 +1,71 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_TIMELISTS_H
+#define PUTOOLS_TIMELISTS_H
+
+#include "PackedTime.h"
+
+#include <vector>
+
+namespace miutil {
+
+/* Set operations on sorted lists of packed times, e.g. the times
+ * available from several data sources. All input lists must be sorted
+ * ascending; duplicates inside one list are allowed.
+ *
+ * Times at most 'tolerance' seconds from the first time of a group are
+ * treated as equal, and the group is represented by its first time.
+ */
+
+typedef std::vector<const std::vector<packed_time>*> time_list_ptrs;
+
+//! k-way merge keeping all elements, including duplicates
+void merge_times(const time_list_ptrs& lists, std::vector<packed_time>& merged);
+
+//! sorted union of all lists without duplicates
+void union_times(const time_list_ptrs& lists, std::vector<packed_time>& result,
+    packed_time tolerance=0);
+
+//! sorted times present in every list
+void intersect_times(const time_list_ptrs& lists, std::vector<packed_time>& result,
+    packed_time tolerance=0);
+
+void merge_times(const std::vector<std::vector<packed_time> >& lists, std::vector<packed_time>& merged);
+void union_times(const std::vector<std::vector<packed_time> >& lists, std::vector<packed_time>& result,
+    packed_time tolerance=0);
+void intersect_times(const std::vector<std::vector<packed_time> >& lists, std::vector<packed_time>& result,
+    packed_time tolerance=0);
+
+/*! Find the coarsest regular axis containing all times of all lists.
+ * \return false if the lists are empty
+ */
+bool common_time_axis(const time_list_ptrs& lists, TimeAxis& axis);
+
+} // namespace miutil
+
+#endif // PUTOOLS_TIMELISTS_H
@@ -0,0 +1,188 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "TimeSeries.h"
+
+#include <algorithm>
+
+namespace /*anonymous*/ {
+
+using miutil::packed_time;
+
+template<typename T>
+inline bool is_missing(T v, T undef)
+{
+  return v == undef || (undef != undef && v != v);
+}
+
+inline bool within(packed_time distance, packed_time tolerance)
+{
+  return tolerance < 0 || distance <= tolerance;
+}
+
+/* The resampling runs in two passes. The first is a merge-style sweep
+ * over the valid source times and the target times; it only decides, for
+ * each target, two source indices and a weight (negative weight means
+ * missing). The second pass is a branch-free loop over these arrays which
+ * the compiler can vectorise. MEAN has no weights and uses prefix sums
+ * instead.
+ */
+template<typename T>
+bool resample_t(const std::vector<packed_time>& src_times, const std::vector<T>& src_values,
+    const std::vector<packed_time>& dst_times, std::vector<T>& dst_values,
+    miutil::ResampleMode mode, T undef, packed_time tolerance)
+{
+  if (src_times.size() != src_values.size())
+    return false;
+
+  // compact valid samples
+  std::vector<packed_time> st;
+  std::vector<T> sv;
+  st.reserve(src_times.size());
+  sv.reserve(src_values.size());
+  for (size_t i=0; i<src_times.size(); ++i) {
+    if (src_times[i] != miutil::PACKED_TIME_UNDEF && !is_missing(src_values[i], undef)) {
+      st.push_back(src_times[i]);
+      sv.push_back(src_values[i]);
+    }
+  }
+
+  const size_t n_src = st.size(), n_dst = dst_times.size();
+  dst_values.assign(n_dst, undef);
+  if (n_src == 0 || n_dst == 0)
+    return true;
+
+  if (mode == miutil::RESAMPLE_MEAN) {
+    std::vector<double> prefix(n_src + 1, 0.0);
+    for (size_t i=0; i<n_src; ++i)
+      prefix[i+1] = prefix[i] + sv[i];
+
+    size_t a = 0, b = 0;
+    packed_time previous = miutil::PACKED_TIME_UNDEF;
+    for (size_t k=0; k<n_dst; ++k) {
+      const packed_time t = dst_times[k];
+      if (t == miutil::PACKED_TIME_UNDEF)
+        continue;
+      if (tolerance < 0) {
+        a = 0;
+        b = n_src;
+      } else {
+        if (t < previous) {
+          a = b = 0;
+        }
+        while (a < n_src && st[a] < t - tolerance)
+          a += 1;
+        if (b < a)
+          b = a;
+        while (b < n_src && st[b] <= t + tolerance)
+          b += 1;
+        previous = t;
+      }
+      if (b > a)
+        dst_values[k] = static_cast<T>((prefix[b] - prefix[a]) / (b - a));
+    }
+    return true;
+  }
+
+  std::vector<size_t> i0(n_dst, 0), i1(n_dst, 0);
+  std::vector<T> w(n_dst, -1);
+
+  size_t j = 0; // number of source times <= current target time
+  packed_time previous = miutil::PACKED_TIME_UNDEF;
+  for (size_t k=0; k<n_dst; ++k) {
+    const packed_time t = dst_times[k];
+    if (t == miutil::PACKED_TIME_UNDEF)
+      continue;
+    if (t < previous)
+      j = std::upper_bound(st.begin(), st.end(), t) - st.begin();
+    while (j < n_src && st[j] <= t)
+      j += 1;
+    previous = t;
+
+    const bool has_lo = (j > 0), has_hi = (j < n_src);
+    const size_t lo = has_lo ? j-1 : 0, hi = has_hi ? j : 0;
+    const bool ok_lo = has_lo && within(t - st[lo], tolerance);
+    const bool ok_hi = has_hi && within(st[hi] - t, tolerance);
+
+    if (mode == miutil::RESAMPLE_PREVIOUS) {
+      if (ok_lo) {
+        i0[k] = i1[k] = lo;
+        w[k] = 0;
+      }
+    } else if (mode == miutil::RESAMPLE_NEAREST) {
+      if (ok_lo && (!ok_hi || t - st[lo] <= st[hi] - t)) {
+        i0[k] = i1[k] = lo;
+        w[k] = 0;
+      } else if (ok_hi) {
+        i0[k] = i1[k] = hi;
+        w[k] = 0;
+      }
+    } else { // RESAMPLE_LINEAR
+      if (ok_lo && st[lo] == t) {
+        i0[k] = i1[k] = lo;
+        w[k] = 0;
+      } else if (ok_lo && ok_hi) {
+        i0[k] = lo;
+        i1[k] = hi;
+        w[k] = static_cast<T>(t - st[lo]) / static_cast<T>(st[hi] - st[lo]);
+      }
+    }
+  }
+
+  const T* v = &sv[0];
+  T* out = &dst_values[0];
+  for (size_t k=0; k<n_dst; ++k) {
+    const T v0 = v[i0[k]], v1 = v[i1[k]];
+    const T value = v0 + w[k] * (v1 - v0);
+    out[k] = (w[k] < 0) ? undef : value;
+  }
+  return true;
+}
+
+} /*anonymous namespace*/
+
+namespace miutil {
+
+bool resample(const std::vector<packed_time>& src_times, const std::vector<float>& src_values,
+    const std::vector<packed_time>& dst_times, std::vector<float>& dst_values,
+    ResampleMode mode, float undef, packed_time tolerance)
+{
+  return resample_t(src_times, src_values, dst_times, dst_values, mode, undef, tolerance);
+}
+
+bool resample(const std::vector<packed_time>& src_times, const std::vector<double>& src_values,
+    const std::vector<packed_time>& dst_times, std::vector<double>& dst_values,
+    ResampleMode mode, double undef, packed_time tolerance)
+{
+  return resample_t(src_times, src_values, dst_times, dst_values, mode, undef, tolerance);
+}
+
+} // namespace miutil
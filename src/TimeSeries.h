@@ -0,0 +1,78 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_TIMESERIES_H
+#define PUTOOLS_TIMESERIES_H
+
+#include "PackedTime.h"
+
+#include <vector>
+
+namespace miutil {
+
+enum ResampleMode {
+  RESAMPLE_NEAREST,  //!< value at the closest source time
+  RESAMPLE_PREVIOUS, //!< value at the latest source time not after the target
+  RESAMPLE_LINEAR,   //!< linear interpolation in time between the two neighbours
+  RESAMPLE_MEAN      //!< mean of all source values inside the window
+};
+
+/*! Resample a (time, value) series onto a list of target times.
+ *
+ * Source times must be sorted ascending; target times are handled
+ * fastest when sorted, too. Source values equal to \c undef (or NaN if
+ * \c undef is NaN) are missing and never used.
+ *
+ * \param tolerance for NEAREST, PREVIOUS and LINEAR the maximum distance
+ *        in seconds between a target time and any source time used for
+ *        it; for MEAN the half-width of the window around the target time;
+ *        negative means unlimited
+ * \param dst_values set to one value per target time, \c undef where no
+ *        usable source value exists
+ * \return false if source times and values differ in size
+ */
+bool resample(const std::vector<packed_time>& src_times, const std::vector<float>& src_values,
+    const std::vector<packed_time>& dst_times, std::vector<float>& dst_values,
+    ResampleMode mode, float undef, packed_time tolerance=-1);
+
+bool resample(const std::vector<packed_time>& src_times, const std::vector<double>& src_values,
+    const std::vector<packed_time>& dst_times, std::vector<double>& dst_values,
+    ResampleMode mode, double undef, packed_time tolerance=-1);
+
+inline bool resample(const std::vector<packed_time>& src_times, const std::vector<float>& src_values,
+    const TimeAxis& axis, std::vector<float>& dst_values,
+    ResampleMode mode, float undef, packed_time tolerance=-1)
+{ return resample(src_times, src_values, axis.times(), dst_values, mode, undef, tolerance); }
+
+inline bool resample(const std::vector<packed_time>& src_times, const std::vector<double>& src_values,
+    const TimeAxis& axis, std::vector<double>& dst_values,
+    ResampleMode mode, double undef, packed_time tolerance=-1)
+{ return resample(src_times, src_values, axis.times(), dst_values, mode, undef, tolerance); }
+
+} // namespace miutil
+
+#endif // PUTOOLS_TIMESERIES_H
@@ -0,0 +1,181 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "TimestampedFile.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace miutil {
+
+TimestampedFile::TimestampedFile()
+  : fd_(-1), data_(0), size_(0)
+{
+}
+
+TimestampedFile::TimestampedFile(const std::string& path)
+  : fd_(-1), data_(0), size_(0)
+{
+  open(path);
+}
+
+TimestampedFile::~TimestampedFile()
+{
+  close();
+}
+
+bool TimestampedFile::open(const std::string& path)
+{
+  close();
+
+  fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    close();
+    return false;
+  }
+  size_ = st.st_size;
+  if (size_ == 0)
+    return true;
+
+  void* m = mmap(0, size_, PROT_READ, MAP_SHARED, fd_, 0);
+  if (m == MAP_FAILED) {
+    close();
+    return false;
+  }
+  // binary search touches few, scattered pages
+  madvise(m, size_, MADV_RANDOM);
+  data_ = static_cast<const char*>(m);
+  return true;
+}
+
+void TimestampedFile::close()
+{
+  if (data_)
+    munmap(const_cast<char*>(data_), size_);
+  if (fd_ >= 0)
+    ::close(fd_);
+  fd_ = -1;
+  data_ = 0;
+  size_ = 0;
+}
+
+bool TimestampedFile::lineTime(size_t pos, packed_time& t) const
+{
+  if (pos >= size_)
+    return false;
+  const char* begin = data_ + pos;
+  const char* end = data_ + size_;
+  if (*begin == '[')
+    ++begin;
+  return parse_iso_time(begin, end, t) != 0;
+}
+
+size_t TimestampedFile::lineStartAtOrAfter(size_t pos) const
+{
+  if (pos == 0 || pos >= size_)
+    return pos < size_ ? pos : size_;
+  if (data_[pos-1] == '\n')
+    return pos;
+  const void* nl = memchr(data_ + pos, '\n', size_ - pos);
+  if (!nl)
+    return size_;
+  return static_cast<const char*>(nl) - data_ + 1;
+}
+
+size_t TimestampedFile::stampedLineAtOrAfter(size_t pos, packed_time& t) const
+{
+  pos = lineStartAtOrAfter(pos);
+  while (pos < size_ && !lineTime(pos, t))
+    pos = lineStartAtOrAfter(pos + 1);
+  return pos;
+}
+
+/* Binary search for the smallest offset whose next line with a time
+ * has time >= t (or > t for the upper bound). The predicate is monotone
+ * because the line times are sorted; when it is false at mid, it is
+ * false for all offsets up to the line found, so lo can skip past it.
+ */
+size_t TimestampedFile::bound(packed_time t, bool upper) const
+{
+  size_t lo = 0, hi = size_;
+  packed_time lt = 0;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    const size_t line = stampedLineAtOrAfter(mid, lt);
+    if (line >= size_ || (upper ? lt > t : lt >= t))
+      hi = mid;
+    else
+      lo = line + 1;
+  }
+  return stampedLineAtOrAfter(lo, lt);
+}
+
+size_t TimestampedFile::lowerBound(packed_time t) const
+{
+  return bound(t, false);
+}
+
+size_t TimestampedFile::upperBound(packed_time t) const
+{
+  return bound(t, true);
+}
+
+bool TimestampedFile::findRange(packed_time t1, packed_time t2, size_t& begin, size_t& end) const
+{
+  if (t2 < t1)
+    return false;
+  begin = lowerBound(t1);
+  end = upperBound(t2);
+  return begin < end;
+}
+
+bool TimestampedFile::nextLine(size_t& pos, size_t end, const char*& line, size_t& length) const
+{
+  if (end > size_)
+    end = size_;
+  if (pos >= end)
+    return false;
+  line = data_ + pos;
+  const void* nl = memchr(line, '\n', end - pos);
+  length = nl ? (static_cast<const char*>(nl) - line) : (end - pos);
+  pos += length + (nl ? 1 : 0);
+  return true;
+}
+
+} // namespace miutil
@@ -0,0 +1,102 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_TIMESTAMPEDFILE_H
+#define PUTOOLS_TIMESTAMPEDFILE_H
+
+#include "PackedTime.h"
+
+#include <string>
+
+namespace miutil {
+
+/*! \brief Memory-mapped text file with lines sorted by a leading ISO time.
+ *
+ * Lines start with a time as accepted by parse_iso_time, optionally
+ * preceded by '['. Lines without a time (e.g. continuation lines) belong
+ * to the previous line with a time. Time ranges are found by binary
+ * search over line boundaries, so only a few pages around the probed
+ * positions are read from disk.
+ */
+class TimestampedFile {
+public:
+  TimestampedFile();
+  explicit TimestampedFile(const std::string& path);
+  ~TimestampedFile();
+
+  bool open(const std::string& path);
+  void close();
+
+  bool isOpen() const
+    { return fd_ >= 0; }
+
+  const char* data() const
+    { return data_; }
+
+  size_t size() const
+    { return size_; }
+
+  //! offset of the first line with time >= t, or size() if none
+  size_t lowerBound(packed_time t) const;
+
+  //! offset of the first line with time > t, or size() if none
+  size_t upperBound(packed_time t) const;
+
+  /*! Find the byte range [begin, end) of all lines with t1 <= time <= t2,
+   * including their continuation lines.
+   * \return false if no line is in the range
+   */
+  bool findRange(packed_time t1, packed_time t2, size_t& begin, size_t& end) const;
+
+  /*! Step through lines in a range found by findRange.
+   * \param pos start of the next line; advanced past it
+   * \param line set to the start of the line
+   * \param length set to the length of the line without '\\n'
+   * \return false when pos has reached end
+   */
+  bool nextLine(size_t& pos, size_t end, const char*& line, size_t& length) const;
+
+  //! time at the start of the line at offset pos
+  bool lineTime(size_t pos, packed_time& t) const;
+
+private:
+  TimestampedFile(const TimestampedFile&);
+  TimestampedFile& operator=(const TimestampedFile&);
+
+  size_t lineStartAtOrAfter(size_t pos) const;
+  size_t stampedLineAtOrAfter(size_t pos, packed_time& t) const;
+  size_t bound(packed_time t, bool upper) const;
+
+private:
+  int fd_;
+  const char* data_;
+  size_t size_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_TIMESTAMPEDFILE_H
@@ -0,0 +1,116 @@
+/*
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "WorkerPool.h"
+
+namespace miutil {
+
+WorkerPool::WorkerPool(size_t threads)
+  : running_(0)
+  , stop_(false)
+{
+  if (threads < 1)
+    threads = 1;
+  for (size_t i=0; i<threads; ++i)
+    threads_.push_back(std::thread(&WorkerPool::run, this));
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    queue_.clear();
+  }
+  wake_.notify_all();
+  for (size_t i=0; i<threads_.size(); ++i)
+    threads_[i].join();
+}
+
+void WorkerPool::submit(const Task& task)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(task);
+  }
+  wake_.notify_one();
+}
+
+size_t WorkerPool::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const size_t n = queue_.size();
+  queue_.clear();
+  if (running_ == 0)
+    idle_.notify_all();
+  return n;
+}
+
+void WorkerPool::wait()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!queue_.empty() || running_ > 0)
+    idle_.wait(lock);
+}
+
+size_t WorkerPool::pending() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size() + running_;
+}
+
+void WorkerPool::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    while (!stop_ && queue_.empty())
+      wake_.wait(lock);
+    if (stop_)
+      break;
+
+    Task task;
+    std::swap(task, queue_.front());
+    queue_.pop_front();
+    running_ += 1;
+    lock.unlock();
+    try {
+      task();
+    } catch (...) {
+      // an exception must not terminate the worker thread
+    }
+    lock.lock();
+    running_ -= 1;
+    if (running_ == 0 && queue_.empty())
+      idle_.notify_all();
+  }
+}
+
+} // namespace miutil
@@ -0,0 +1,85 @@
+/* -*- c++ -*-
+  libpuTools - Basic types/algorithms/containers
+
+  Copyright (C) 2026 met.no
+
+  Contact information:
+  Norwegian Meteorological Institute
+  Box 43 Blindern
+  0313 OSLO
+  NORWAY
+  email: diana@met.no
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PUTOOLS_WORKERPOOL_H
+#define PUTOOLS_WORKERPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace miutil {
+
+/*! \brief A small fixed-size pool of threads running queued tasks.
+ *
+ * Tasks run in submission order (with more than one thread, several run
+ * at once). Destroying the pool drops all queued tasks and waits for the
+ * running ones to finish.
+ */
+class WorkerPool {
+public:
+  typedef std::function<void()> Task;
+
+  explicit WorkerPool(size_t threads=1);
+  ~WorkerPool();
+
+  void submit(const Task& task);
+
+  //! drop all queued, not yet started tasks; returns the number dropped
+  size_t clear();
+
+  //! block until no task is queued or running
+  void wait();
+
+  //! number of tasks queued or running
+  size_t pending() const;
+
+  size_t threads() const
+    { return threads_.size(); }
+
+private:
+  WorkerPool(const WorkerPool&);
+  WorkerPool& operator=(const WorkerPool&);
+
+  void run();
+
+private:
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  std::deque<Task> queue_;
+  size_t running_;
+  bool stop_;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace miutil
+
+#endif // PUTOOLS_WORKERPOOL_H
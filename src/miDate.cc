@@ -36,6 +36,7 @@
 
 #include "miDate.h"
 
+#include "FormatContext.h"
 #include "miString.h"
 
 #include <iostream>
@@ -57,6 +58,13 @@ static inline void warning(const std::string& s)
   std::cerr << "Warning: miDate::" << s << std::endl;
 }
 
+// utf8 flag for calls that do not specify it
+static inline bool default_utf8()
+{
+  const FormatContext* context = FormatContext::current();
+  return context && context->utf8;
+}
+
 static const long julianDayZero=1721425;
 
 static const int monthLength[14]={
@@ -88,8 +96,13 @@ miutil::miDate::dayOfYear() const
 std::string miDate::language(const std::string& l)
 {
   std::string la = l;
-  if (la.empty())
+  if (la.empty()) {
+    const FormatContext* context = FormatContext::current();
+    if (context && !context->language.empty())
+      la = context->language;
+    else
       la = defaultLanguage;
+  }
   return miutil::to_lower(la);
 }
 
@@ -285,7 +298,7 @@ miutil::miDate::weekday(const lang l) const
 std::string
 miutil::miDate::weekday(const std::string& l) const
 {
-  return weekday(l, false);
+  return weekday(l, default_utf8());
 }
 
 std::string
@@ -386,7 +399,7 @@ miutil::miDate::shortweekday(const lang l) const
 std::string
 miutil::miDate::shortweekday(const std::string& l) const
 {
-  return shortweekday(l, false);
+  return shortweekday(l, default_utf8());
 }
 
 std::string
@@ -485,7 +498,7 @@ miutil::miDate::monthname(const lang l) const
 std::string
 miutil::miDate::monthname(const std::string& l) const
 {
-  return monthname(l, false);
+  return monthname(l, default_utf8());
 }
 
 std::string
@@ -582,7 +595,7 @@ miutil::miDate::shortmonthname(const lang l) const
 std::string
 miutil::miDate::shortmonthname(const std::string& l) const
 {
-  return shortmonthname(l, false);
+  return shortmonthname(l, default_utf8());
 }
 
 std::string
@@ -715,7 +728,7 @@ miutil::miDate::format(const std::string& newDate,const lang l) const
 std::string
 miutil::miDate::format(const std::string& newDate, const std::string& l) const
 {
-  return format(newDate, l, false);
+  return format(newDate, l, default_utf8());
 }
 
 std::string
@@ -177,6 +177,8 @@ public:
   std::string format(const std::string&, const std::string& lang, bool utf8) const;
 
 
+  // process-wide and not thread-safe; a language from the calling
+  // thread's FormatContext takes precedence
   void setDefaultLanguage(const char* l=""){ defaultLanguage=l; }
 
   static miDate today(); // return system date
@@ -31,23 +31,213 @@
 
 #include "miDirtools.h"
 
-#include "miStringFunctions.h"
+#include "NameMatcher.h"
+#include "PathNormalizer.h"
 #include <puCtools/stat.h>
 
 #include <cstring>
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <libgen.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
-#if defined(WITH_REGEXP) && defined(linux)
-#include <regex.h>
+#ifdef __linux__
+#include <sys/syscall.h>
 #endif
 
 using namespace std;
 
+namespace /*anonymous*/ {
+
+miutil::DirEntries::Type type_from_dirent(unsigned char d_type)
+{
+  switch (d_type) {
+  case DT_REG: return miutil::DirEntries::TYPE_FILE;
+  case DT_DIR: return miutil::DirEntries::TYPE_DIR;
+  case DT_LNK: return miutil::DirEntries::TYPE_LINK;
+  case DT_UNKNOWN: return miutil::DirEntries::TYPE_UNKNOWN;
+  default: return miutil::DirEntries::TYPE_OTHER;
+  }
+}
+
+miutil::DirEntries::Type type_from_mode(mode_t mode)
+{
+  if (S_ISREG(mode))
+    return miutil::DirEntries::TYPE_FILE;
+  if (S_ISDIR(mode))
+    return miutil::DirEntries::TYPE_DIR;
+  if (S_ISLNK(mode))
+    return miutil::DirEntries::TYPE_LINK;
+  return miutil::DirEntries::TYPE_OTHER;
+}
+
+inline bool is_dot_or_dotdot(const char* name)
+{
+  return name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0));
+}
+
+/* Add one entry, stat'ing it relative to dfd if fields need it.
+ * Returns false if the entry should be left out.
+ */
+bool add_entry(int dfd, const char* name, unsigned char d_type, uint64_t inode, unsigned int fields,
+    const miutil::NameMatcher* matcher, miutil::DirEntries& entries)
+{
+  if (!(fields & miutil::SCAN_DOTS) && is_dot_or_dotdot(name))
+    return false;
+  const size_t length = strlen(name);
+  if (matcher && !matcher->match(name, length))
+    return false;
+
+  miutil::DirEntries::Type type = type_from_dirent(d_type);
+  const bool need_stat = (fields & (miutil::SCAN_MTIME | miutil::SCAN_CTIME | miutil::SCAN_SIZE))
+      || ((fields & miutil::SCAN_TYPE) && (type == miutil::DirEntries::TYPE_UNKNOWN));
+  if (!need_stat) {
+    entries.add(name, length, type, 0, 0, 0, inode);
+    return true;
+  }
+
+  int64_t mtime = 0, ctime = 0, size = 0;
+#if defined(__linux__) && defined(STATX_TYPE)
+  unsigned int mask = STATX_TYPE;
+  if (fields & miutil::SCAN_MTIME)
+    mask |= STATX_MTIME;
+  if (fields & miutil::SCAN_CTIME)
+    mask |= STATX_CTIME;
+  if (fields & miutil::SCAN_SIZE)
+    mask |= STATX_SIZE;
+  const int flags = AT_STATX_SYNC_AS_STAT
+      | ((fields & miutil::SCAN_NOFOLLOW) ? AT_SYMLINK_NOFOLLOW : 0);
+  struct statx sx;
+  if (statx(dfd, name, flags, mask, &sx) != 0)
+    return false;
+  type = type_from_mode(sx.stx_mode);
+  mtime = sx.stx_mtime.tv_sec;
+  ctime = sx.stx_ctime.tv_sec;
+  size = sx.stx_size;
+#else
+  struct stat st;
+  if (fstatat(dfd, name, &st, (fields & miutil::SCAN_NOFOLLOW) ? AT_SYMLINK_NOFOLLOW : 0) != 0)
+    return false;
+  type = type_from_mode(st.st_mode);
+  mtime = st.st_mtime;
+  ctime = st.st_ctime;
+  size = st.st_size;
+#endif
+  entries.add(name, length, type,
+      (fields & miutil::SCAN_MTIME) ? mtime : 0,
+      (fields & miutil::SCAN_CTIME) ? ctime : 0,
+      (fields & miutil::SCAN_SIZE) ? size : 0, inode);
+  return true;
+}
+
+#ifdef __linux__
+// layout of the records returned by getdents64
+struct linux_dirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[1];
+};
+
+const size_t GETDENTS_BUFFER_SIZE = 256 * 1024;
+#endif
+
+// largest batch passed on by scan_directory_batches
+const size_t MAX_BATCH_ENTRIES = 1024;
+
+inline bool is_cancelled(const std::atomic<bool>* cancel)
+{
+  return cancel && cancel->load(std::memory_order_relaxed);
+}
+
+/* Read the directory open as dfd into entries, from its start; with
+ * batch, entries are passed to it and cleared after each block read from
+ * the directory, or when there are MAX_BATCH_ENTRIES. Stops early if
+ * cancel is set. dfd stays open.
+ */
+bool scan_entries_fd(int dfd, unsigned int fields, const miutil::NameMatcher* matcher,
+    miutil::DirEntries& entries, const miutil::ScanBatchCallback* batch, const std::atomic<bool>* cancel)
+{
+  entries.clear();
+  if (lseek(dfd, 0, SEEK_SET) < 0)
+    return false;
+
+  bool ok = true;
+#ifdef __linux__
+  std::vector<char> buffer(GETDENTS_BUFFER_SIZE);
+  while (ok) {
+    const long n = syscall(SYS_getdents64, dfd, &buffer[0], buffer.size());
+    if (n <= 0) {
+      ok = (n == 0);
+      break;
+    }
+    for (long pos = 0; pos < n; ) {
+      if (is_cancelled(cancel)) {
+        ok = false;
+        break;
+      }
+      const linux_dirent64* d = reinterpret_cast<const linux_dirent64*>(&buffer[pos]);
+      pos += d->d_reclen;
+      add_entry(dfd, d->d_name, d->d_type, d->d_ino, fields, matcher, entries);
+      if (batch && entries.size() >= MAX_BATCH_ENTRIES) {
+        (*batch)(entries);
+        entries.clear();
+      }
+    }
+    if (ok && batch && !entries.empty()) {
+      (*batch)(entries);
+      entries.clear();
+    }
+  }
+#else
+  // closedir closes the descriptor given to fdopendir
+  const int dir_fd = dup(dfd);
+  if (dir_fd < 0)
+    return false;
+  DIR* dirp = fdopendir(dir_fd);
+  if (!dirp) {
+    close(dir_fd);
+    return false;
+  }
+  while (dirent* dp = readdir(dirp)) {
+    if (is_cancelled(cancel)) {
+      ok = false;
+      break;
+    }
+    add_entry(dfd, dp->d_name, dp->d_type, dp->d_ino, fields, matcher, entries);
+    if (batch && entries.size() >= MAX_BATCH_ENTRIES) {
+      (*batch)(entries);
+      entries.clear();
+    }
+  }
+  closedir(dirp);
+  if (ok && batch && !entries.empty()) {
+    (*batch)(entries);
+    entries.clear();
+  }
+#endif
+  return ok;
+}
+
+bool scan_entries(const std::string& directory, unsigned int fields, const miutil::NameMatcher* matcher,
+    miutil::DirEntries& entries, const miutil::ScanBatchCallback* batch, const std::atomic<bool>* cancel)
+{
+  const int dfd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dfd < 0) {
+    entries.clear();
+    return false;
+  }
+  const bool ok = scan_entries_fd(dfd, fields, matcher, entries, batch, cancel);
+  close(dfd);
+  return ok;
+}
+
+} /*anonymous namespace*/
+
 namespace miutil {
 long path_ctime(const std::string& path)
 {
@@ -56,94 +246,122 @@ long path_ctime(const std::string& path)
     return 0;
   return buf.st_ctime;
 }
+
+void DirEntries::add(const char* name, size_t length, Type type, int64_t mtime, int64_t ctime, int64_t size,
+    uint64_t inode)
+{
+  Record r;
+  r.offset = names_.size();
+  r.length = length;
+  r.type = type;
+  r.mtime = mtime;
+  r.ctime = ctime;
+  r.size = size;
+  r.inode = inode;
+  names_.insert(names_.end(), name, name + length);
+  names_.push_back(0);
+  records_.push_back(r);
+}
+
+bool scan_directory(const std::string& directory, unsigned int fields, DirEntries& entries)
+{
+  return scan_entries(directory, fields, 0, entries, 0, 0);
+}
+
+bool scan_directory(const std::string& directory, unsigned int fields, const NameMatcher& matcher,
+    DirEntries& entries)
+{
+  return scan_entries(directory, fields, matcher.kind() == NameMatcher::ANY ? 0 : &matcher, entries, 0, 0);
+}
+
+bool scan_directory_batches(const std::string& directory, unsigned int fields, const NameMatcher& matcher,
+    const ScanBatchCallback& batch, const std::atomic<bool>* cancel)
+{
+  DirEntries entries;
+  return scan_entries(directory, fields, matcher.kind() == NameMatcher::ANY ? 0 : &matcher, entries,
+      &batch, cancel);
+}
+
+bool scan_directory_batches(int dfd, unsigned int fields, const NameMatcher& matcher,
+    const ScanBatchCallback& batch, const std::atomic<bool>* cancel)
+{
+  DirEntries entries;
+  return scan_entries_fd(dfd, fields, matcher.kind() == NameMatcher::ANY ? 0 : &matcher, entries,
+      &batch, cancel);
+}
+
 } // namespace miutil
 
 std::string getRecent(const std::string& cat)
 {
-  DIR *dirp;
-  dirent *dp;
+  // entries that cannot be stat'ed are not passed on; only the newest
+  // name is kept
   std::string last;
-  std::string c = cat + "/";
-  int l = 0;
-
-  if ((dirp= opendir(cat.c_str()))) {
-    while ((dp= readdir(dirp))) {
-      if (strlen(dp->d_name)>0) {
-        std::string name = c + dp->d_name;
-        struct stat st;
-        stat(name.c_str(), &st);
-        if ( l < st.st_ctime ) {
-          l = st.st_ctime;
-          last = name;
+  int64_t l = 0;
+  miutil::scan_directory_batches(cat, miutil::SCAN_CTIME, miutil::NameMatcher(),
+      [&](const miutil::DirEntries& entries) {
+        for (size_t i=0; i<entries.size(); ++i) {
+          if (l < entries.ctime(i)) {
+            l = entries.ctime(i);
+            last.assign(entries.name(i), entries.nameLength(i));
+          }
         }
-      }
-    }
-    closedir(dirp);
-  }
+      });
+  if (!last.empty())
+    last = cat + "/" + last;
   return last;
 }
 
 
 bool getFilenames(const std::string& cat, vector<std::string>& names)
 {
-  DIR *dirp;
-  dirent *dp;
-  if (!(dirp= opendir(cat.c_str())))
+  miutil::DirEntries entries;
+  if (!miutil::scan_directory(cat, miutil::SCAN_NAMES | miutil::SCAN_DOTS, entries))
     return false;
 
-  while ((dp= readdir(dirp))) {
-    if (strlen(dp->d_name) > 0)
-      names.push_back(dp->d_name);
-  }
-  closedir(dirp);
+  names.reserve(names.size() + entries.size());
+  for (size_t i=0; i<entries.size(); ++i)
+    names.push_back(std::string(entries.name(i), entries.nameLength(i)));
   return true;
 }
 
 
-bool getFilenamesByExt(const std::string& cat,
-    const std::string& ext, vector<std::string>& names)
+bool getFilenames(const std::string& cat, const miutil::NameMatcher& matcher,
+    std::vector<std::string>& names)
 {
-  vector<std::string> allnames;
-  if (!getFilenames(cat, allnames))
+  if (!matcher.ok())
+    return false;
+  miutil::DirEntries entries;
+  if (!miutil::scan_directory(cat, miutil::SCAN_NAMES, matcher, entries))
     return false;
 
-  for (unsigned int i=0; i<allnames.size(); i++){
-    if (allnames[i]!="." && allnames[i]!=".."){
-      const vector<std::string> splitv = miutil::split(allnames[i], ".", false);
-      if (splitv.size()) {
-        const std::string& cext = splitv[splitv.size()-1];
-        if (cext == ext)
-          names.push_back(allnames[i]);
-      }
-    }
-  }
+  names.reserve(names.size() + entries.size());
+  for (size_t i=0; i<entries.size(); ++i)
+    names.push_back(std::string(entries.name(i), entries.nameLength(i)));
   return true;
 }
 
 
-std::string hardpath(const std::string& fname)
+bool getFilenamesByExt(const std::string& cat,
+    const std::string& ext, vector<std::string>& names)
 {
-  std::string cwd = getcwd(NULL,128);
-  cwd+="/"+fname;
-  vector<std::string> vcwd = miutil::split(cwd, "/", true);
-  vector<std::string>::iterator itr = vcwd.begin();
+  return getFilenames(cat, miutil::NameMatcher::extension(ext), names);
+}
+
 
-  if ( fname == "")
-    return cwd;
-  else if ( fname.c_str()[0] ==  '/')
+std::string hardpath(const std::string& fname)
+{
+  // absolute names are returned unchanged, as before
+  if (!fname.empty() && fname[0] == '/')
     return fname;
-  cwd = "";
-
-  for(; itr != vcwd.end(); itr++)
-    if( *itr == ".." ){
-      itr--;
-      vcwd.erase(itr);
-      vcwd.erase(itr);
-      itr--;
-    }
-   for(itr = vcwd.begin(); itr != vcwd.end(); itr++)
-     cwd+="/"+(*itr);
-   return cwd;
+
+  std::string path = miutil::current_directory();
+  path += '/';
+  if (fname.empty())
+    return path;
+  path += fname;
+  miutil::normalize_path(path);
+  return path;
 }
 
 
@@ -151,38 +369,7 @@ bool getFilenamesByRegexp(const std::string& cat,
     const std::string& reg, std::vector<std::string>& names)
 {
 #if defined(WITH_REGEXP)
-  std::vector<std::string> allnames;
-#ifdef linux
-  regex_t preg;
-  int res= regcomp(&preg, reg.c_str(), REG_EXTENDED | REG_NOSUB);
-  if (res!=0 || !getFilenames(cat, allnames))
-    return false;
-
-  int nmatch= 0;
-  int eflags= 0;
-  regmatch_t pmatch;
-  for (unsigned int i=0; i<allnames.size(); i++){
-    if (allnames[i]!="." && allnames[i]!=".."){
-      res= regexec(&preg, allnames[i].c_str(), nmatch, &pmatch, eflags);
-      if (res==0) names.push_back(allnames[i]);
-    }
-  }
-  regfree(&preg);
-#else // !linux
-  char *creg= regcmp(reg.c_str(),(char*)0);
-  char *result;
-  if (!creg || !getFilenames(cat, allnames))
-    return false;
-
-  for (int i=0; i<allnames.size(); i++){
-    if (allnames[i]!="." && allnames[i]!=".."){
-      result= regex(creg, allnames[i].c_str());
-      if (result) names.push_back(allnames[i]);
-    }
-  }
-  free(creg);
-#endif // !linux
-  return true;
+  return getFilenames(cat, miutil::NameMatcher::regexp(reg), names);
 #else // !WITH_REGEXP
   return false;
 #endif
@@ -28,17 +28,141 @@
 #ifndef _miDirtools_h
 #define _miDirtools_h
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
 namespace miutil {
 
+class NameMatcher;
+
 /*! Determine the modification time for a given path.
  * \param path the path to check
  * \return the modification time, or 0 if not found
  */
 long path_ctime(const std::string& path);
 
+/*! Compact list of directory entries.
+ *
+ * Names are stored one after the other in a single buffer, '\0'-terminated,
+ * and the other fields in a parallel array, so a large directory costs
+ * two allocations instead of one per name.
+ */
+class DirEntries {
+public:
+  enum Type { TYPE_UNKNOWN, TYPE_FILE, TYPE_DIR, TYPE_LINK, TYPE_OTHER };
+
+  size_t size() const
+    { return records_.size(); }
+
+  bool empty() const
+    { return records_.empty(); }
+
+  //! name of entry i; valid until the list is changed
+  const char* name(size_t i) const
+    { return &names_[records_[i].offset]; }
+
+  size_t nameLength(size_t i) const
+    { return records_[i].length; }
+
+  Type type(size_t i) const
+    { return static_cast<Type>(records_[i].type); }
+
+  //! modification time, seconds since 1970; 0 unless scanned with SCAN_MTIME
+  int64_t mtime(size_t i) const
+    { return records_[i].mtime; }
+
+  //! status change time, seconds since 1970; 0 unless scanned with SCAN_CTIME
+  int64_t ctime(size_t i) const
+    { return records_[i].ctime; }
+
+  //! size in bytes; 0 unless scanned with SCAN_SIZE
+  int64_t fileSize(size_t i) const
+    { return records_[i].size; }
+
+  //! inode number as given by the directory
+  uint64_t inode(size_t i) const
+    { return records_[i].inode; }
+
+  void clear()
+    { names_.clear(); records_.clear(); }
+
+  void add(const char* name, size_t length, Type type, int64_t mtime=0, int64_t ctime=0, int64_t size=0,
+      uint64_t inode=0);
+
+private:
+  struct Record {
+    size_t offset;
+    uint16_t length;
+    uint8_t type;
+    int64_t mtime;
+    int64_t ctime;
+    int64_t size;
+    uint64_t inode;
+  };
+
+  std::vector<char> names_;
+  std::vector<Record> records_;
+};
+
+enum ScanFields {
+  SCAN_NAMES = 0,  //!< names and the type the directory gives, no stat
+  SCAN_TYPE  = 1,  //!< stat entries of unknown type
+  SCAN_MTIME = 2,
+  SCAN_CTIME = 4,
+  SCAN_SIZE  = 8,
+  SCAN_DOTS  = 16, //!< include "." and ".."
+  SCAN_NOFOLLOW = 32 //!< stat symbolic links themselves, not what they point to
+};
+
+/*! List a directory.
+ *
+ * Entries are read in large batches. Only if fields other than the names
+ * are requested, each entry is stat'ed relative to the directory, asking
+ * only for these fields where the system allows it; the type is then
+ * that of the file a symbolic link points to, unless SCAN_NOFOLLOW is
+ * given. Entries that vanish before they are stat'ed are left out.
+ *
+ * \param fields bitwise or of ScanFields
+ * \param entries set to the entries, in directory order
+ * \return false if the directory cannot be read
+ */
+bool scan_directory(const std::string& directory, unsigned int fields, DirEntries& entries);
+
+/*! List the entries of a directory whose names match.
+ *
+ * Names are tested as they are read, so other entries are neither
+ * stat'ed nor copied.
+ */
+bool scan_directory(const std::string& directory, unsigned int fields, const NameMatcher& matcher,
+    DirEntries& entries);
+
+typedef std::function<void(const DirEntries& batch)> ScanBatchCallback;
+
+/*! List a directory in batches of the entries read at once.
+ *
+ * Like scan_directory, but the entries are passed to batch as they are
+ * read and not kept, so memory use does not grow with the size of the
+ * directory. A batch has at most 1024 entries and is only valid during
+ * the call.
+ *
+ * \param cancel if given and set, reading stops before the next entry
+ * \return false if the directory cannot be read or reading was cancelled
+ */
+bool scan_directory_batches(const std::string& directory, unsigned int fields, const NameMatcher& matcher,
+    const ScanBatchCallback& batch, const std::atomic<bool>* cancel = 0);
+
+/*! As above, for a directory opened with O_DIRECTORY.
+ *
+ * The directory is read from its start and dfd stays open, so that the
+ * entries can be acted on with the *at functions relative to the same
+ * directory, even if it is renamed or replaced meanwhile.
+ */
+bool scan_directory_batches(int dfd, unsigned int fields, const NameMatcher& matcher,
+    const ScanBatchCallback& batch, const std::atomic<bool>* cancel = 0);
+
 } // namespace miutil
 
 // get the newest modificated file from catalog 'cat'
@@ -47,6 +171,10 @@ extern std::string getRecent(const std::string& cat);
 // get all filenames from catalog 'cat'
 extern bool getFilenames(const std::string& cat, std::vector<std::string>& names);
 
+// get all filenames accepted by 'matcher' from catalog 'cat', without "." and ".."
+extern bool getFilenames(const std::string& cat, const miutil::NameMatcher& matcher,
+    std::vector<std::string>& names);
+
 // get all files with extension 'ext' from catalog 'cat'
 extern bool getFilenamesByExt(const std::string& cat,
     const std::string& ext, std::vector<std::string>& names);
@@ -57,6 +185,8 @@ extern bool getFilenamesByExt(const std::string& cat,
 // hardpath()            : result /pug/local/include
 // hardpath(puTools)     : result /pug/local/include/puTools
 // hardpath(/usr/local)  : result /usr/local
+// relative paths are normalised lexically, see miutil::normalize_path;
+// absolute paths are returned unchanged
 
 extern std::string hardpath(const std::string&);
 
@@ -34,8 +34,12 @@
 #define METLIBS_SUPPRESS_DEPRECATED
 #include "miString.h"
 
+#include "CharClass.h"
+
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/optional.hpp>
 #include <iomanip>
+#include <cstring>
 
 using namespace puAlgo;
 
@@ -45,6 +49,40 @@ bool empty_after_trim(std::string& text)
     miutil::trim(text);
     return text.empty();
 }
+
+// buffer is only filled for other characters than whitespaces
+const miutil::CharClass& char_class(const char* chars, boost::optional<miutil::CharClass>& buffer)
+{
+    if (chars == miutil::whitespaces)
+        return miutil::CharClass::whitespace();
+    buffer = miutil::CharClass(chars);
+    return *buffer;
+}
+
+size_t find_first_of(const boost::string_ref& text, const miutil::CharClass& set, size_t pos)
+{
+    return set.find_first_of(text.data(), text.size(), pos);
+}
+
+size_t find_first_not_of(const boost::string_ref& text, const miutil::CharClass& set, size_t pos)
+{
+    return set.find_first_not_of(text.data(), text.size(), pos);
+}
+
+size_t find(const boost::string_ref& text, char c, size_t pos)
+{
+    if (pos >= text.size())
+        return std::string::npos;
+    const void* p = memchr(text.data() + pos, c, text.size() - pos);
+    return p ? static_cast<const char*>(p) - text.data() : std::string::npos;
+}
+
+void to_strings(const std::vector<boost::string_ref>& tokens, std::vector<std::string>& strings)
+{
+    strings.reserve(tokens.size());
+    for (size_t i=0; i<tokens.size(); ++i)
+        strings.push_back(std::string(tokens[i].data(), tokens[i].size()));
+}
 } /* anonymous namespace */
 
 // ########################################################################
@@ -105,10 +143,12 @@ void trim(std::string& text, bool left, bool right, const char* wspace)
 {
     if (text.empty())
         return;
-    
+
+    boost::optional<CharClass> buffer;
+    const CharClass& ws = char_class(wspace, buffer);
     const size_t len = text.length();
     if (left) {
-        const size_t pos = text.find_first_not_of(wspace);
+        const size_t pos = ws.find_first_not_of(text.data(), len);
         if (pos==std::string::npos) {
             text.clear();
             return;
@@ -117,12 +157,12 @@ void trim(std::string& text, bool left, bool right, const char* wspace)
             text = text.substr(pos, len-pos);
     }
     if (right) {
-        const size_t pos = text.find_last_not_of(wspace);
+        const size_t pos = ws.find_last_not_of(text.data(), text.length());
         if (pos==std::string::npos) {
             text.clear();
             return;
         }
-        if (pos<len-1)
+        if (pos<text.length()-1)
             text = text.substr(0, pos+1);
     }
 }
@@ -134,63 +174,81 @@ void trim_remove_empty(std::vector<std::string>& vec)
     vec = cleaned;
 }
 
-std::vector<std::string> split(const std::string& text, int nos, const char* separator_chars, const bool clean)
+void trim_remove_empty(std::vector<boost::string_ref>& tokens)
 {
-    std::vector<std::string> vec;
+    const CharClass& ws = CharClass::whitespace();
+    size_t kept = 0;
+    for (size_t i=0; i<tokens.size(); ++i) {
+        const boost::string_ref t = tokens[i];
+        const size_t first = find_first_not_of(t, ws, 0);
+        if (first == std::string::npos)
+            continue;
+        const size_t last = ws.find_last_not_of(t.data(), t.size());
+        tokens[kept++] = t.substr(first, last + 1 - first);
+    }
+    tokens.resize(kept);
+}
+
+void split(std::vector<boost::string_ref>& tokens, boost::string_ref text, int nos,
+           const char* separator_chars, const bool clean)
+{
+    tokens.clear();
     if (text.empty())
-        return vec;
+        return;
 
+    boost::optional<CharClass> buffer;
+    const CharClass& separators = char_class(separator_chars, buffer);
     int splitnumber = 0;
-    size_t len = text.length();
-    size_t start=(clean? text.find_first_not_of(separator_chars, 0): 0);
-    while (start != std::string::npos && start<len) {
-        size_t stop = text.find_first_of(separator_chars, start);
-        if (stop == std::string::npos || stop > len)
-            stop=len;
-        vec.push_back(text.substr(start, stop-start));
-        
-        if(nos)
-            if(++splitnumber >= nos) {
+    const size_t len = text.size();
+    size_t start = (clean ? find_first_not_of(text, separators, 0) : 0);
+    while (start != std::string::npos && start < len) {
+        size_t stop = find_first_of(text, separators, start);
+        if (stop == std::string::npos)
+            stop = len;
+        tokens.push_back(text.substr(start, stop-start));
+
+        if (nos)
+            if (++splitnumber >= nos) {
                 stop++;
-                if(stop < len )
-                    vec.push_back(text.substr(stop,len-stop));
+                if (stop < len)
+                    tokens.push_back(text.substr(stop, len-stop));
                 break;
             }
-        start=(clean? text.find_first_not_of(separator_chars, stop+1): stop+1);
+        start = (clean ? find_first_not_of(text, separators, stop+1) : stop+1);
     }
-    
-    if (clean)
-        trim_remove_empty(vec);
 
-    return vec;
+    if (clean)
+        trim_remove_empty(tokens);
 }
 
-std::vector<std::string> split_protected(const std::string& text,
-                                         const char lb, // left border
-                                         const char rb, // right border
-                                         const char* separator_chars,
-                                         const bool clean)
+void split_protected(std::vector<boost::string_ref>& tokens, boost::string_ref text,
+                     const char lb, // left border
+                     const char rb, // right border
+                     const char* separator_chars,
+                     const bool clean)
 {
-    std::vector<std::string> vec;
+    tokens.clear();
     if (text.empty())
-        return vec;
+        return;
 
-    const size_t len = text.length();
-    size_t start = (clean ? text.find_first_not_of(separator_chars, 0): 0);
+    boost::optional<CharClass> buffer;
+    const CharClass& separators = char_class(separator_chars, buffer);
+    const size_t len = text.size();
+    size_t start = (clean ? find_first_not_of(text, separators, 0) : 0);
 
     while (start != std::string::npos && start<len) {
-        size_t stop = text.find_first_of(separator_chars, start);
+        size_t stop = find_first_of(text, separators, start);
         size_t tmp = start;
         bool isok = false;
         while (not isok) {
-            const size_t lbp = text.find(lb, tmp);
+            const size_t lbp = find(text, lb, tmp);
             if (lbp != std::string::npos && lbp < stop) {
-                const size_t rbp = text.find(rb, lbp+1);
+                const size_t rbp = find(text, rb, lbp+1);
                 if (rbp == std::string::npos)
-                    return vec;
+                    return; // unbalanced, tokens so far are not cleaned
                 tmp = rbp+1;
-                if (rbp != std::string::npos && rbp > stop)
-                    stop = text.find_first_of(separator_chars, tmp);
+                if (rbp > stop)
+                    stop = find_first_of(text, separators, tmp);
             } else {
                 isok = true;
             }
@@ -198,13 +256,33 @@ std::vector<std::string> split_protected(const std::string& text,
         if (stop == std::string::npos || stop>len)
             stop=len;
 
-        vec.push_back(text.substr(start, stop-start));
-        start = (clean ? text.find_first_not_of(separator_chars, stop+1): stop+1);
+        tokens.push_back(text.substr(start, stop-start));
+        start = (clean ? find_first_not_of(text, separators, stop+1): stop+1);
     }
-    
+
     if (clean)
-        trim_remove_empty(vec);
+        trim_remove_empty(tokens);
+}
+
+std::vector<std::string> split(const std::string& text, int nos, const char* separator_chars, const bool clean)
+{
+    std::vector<boost::string_ref> tokens;
+    split(tokens, text, nos, separator_chars, clean);
+    std::vector<std::string> vec;
+    to_strings(tokens, vec);
+    return vec;
+}
 
+std::vector<std::string> split_protected(const std::string& text,
+                                         const char lb, // left border
+                                         const char rb, // right border
+                                         const char* separator_chars,
+                                         const bool clean)
+{
+    std::vector<boost::string_ref> tokens;
+    split_protected(tokens, text, lb, rb, separator_chars, clean);
+    std::vector<std::string> vec;
+    to_strings(tokens, vec);
     return vec;
 }
 
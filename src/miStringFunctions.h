@@ -28,6 +28,8 @@
 #ifndef metlibs_puTools_miStringFunctions
 #define metlibs_puTools_miStringFunctions
 
+#include <boost/utility/string_ref.hpp>
+
 #include <algorithm>
 #include <climits> 
 #include <cmath>
@@ -63,6 +65,23 @@ inline std::vector<std::string> split(const std::string& text, const std::string
 std::vector<std::string> split_protected(const std::string& text, const char left, const char right,
                                          const char* separator_chars=whitespaces, const bool clean=true);
 
+/*! Split without copying: tokens refer to text, which must outlive them.
+ *
+ * Same results as the split and split_protected above; tokens is
+ * cleared first, and no memory is allocated once it has grown large
+ * enough, so it should be reused for many lines.
+ */
+void split(std::vector<boost::string_ref>& tokens, boost::string_ref text, int nos,
+           const char* separator_chars=whitespaces, const bool clean=true);
+inline void split(std::vector<boost::string_ref>& tokens, boost::string_ref text,
+                  const char* separator_chars=whitespaces, const bool clean=true)
+{ split(tokens, text, 0, separator_chars, clean); }
+void split_protected(std::vector<boost::string_ref>& tokens, boost::string_ref text, const char left, const char right,
+                     const char* separator_chars=whitespaces, const bool clean=true);
+
+/// trim tokens and remove empty ones, in place
+void trim_remove_empty(std::vector<boost::string_ref>& tokens);
+
 void remove(std::string& text, const char c);
 void replace(std::string& text, const char thys, const char that);
 void replace(std::string& text, const std::string& thys, const std::string& that);
@@ -36,6 +36,8 @@
 #endif
 
 #include "miTime.h"
+
+#include "FormatContext.h"
 #include "miString.h"
 
 #include <cstdio>
@@ -426,17 +428,36 @@ miutil::miTime::format(const std::string& newTime, const miDate::lang l) const
 std::string
 miutil::miTime::format(const std::string& nt, const std::string& lang) const
 {
-  return format(nt, lang, false);
+  const FormatContext* context = FormatContext::current();
+  return format(nt, lang, context && context->utf8);
 }
 
 std::string
 miutil::miTime::format(const std::string& nt, const std::string& lang, bool utf8) const
+{
+  const FormatContext* context = FormatContext::current();
+  return formatInZone(nt, lang, utf8, context ? context->zone : std::string());
+}
+
+std::string
+miutil::miTime::format(const std::string& nt, const FormatContext& context) const
+{
+  return formatInZone(nt, context.language, context.utf8, context.zone);
+}
+
+std::string
+miutil::miTime::formatInZone(const std::string& nt, const std::string& lang, bool utf8, const std::string& zone) const
 {
   std::string newTime(nt), l(lang);
   miutil::replace(newTime, "%c","%a %b %d %X GMT %Y");
 
   miTime ftim(Date,Clock);
 
+  if (!zone.empty() && !miutil::contains(newTime, "$tz=")) {
+    miutil::replace(newTime, "%tz", zone);
+    ftim.addHour(ftim.timezone(zone));
+  }
+
   int k;
   vector<std::string> token,remove;
 
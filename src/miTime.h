@@ -42,6 +42,8 @@
 
 namespace miutil{
 
+struct FormatContext;
+
 class miTime {
   miDate Date;
   miClock Clock;
@@ -156,11 +158,18 @@ public:
   std::string format(const std::string&, const std::string& lang="") const;
   std::string format(const std::string&, const std::string& lang, bool utf8) const;
 
+  // language, utf8 flag and time zone from context; a "$tz=" in the
+  // format string overrides the zone
+  std::string format(const std::string&, const FormatContext& context) const;
+
   // New faster version using boost date/time
   static std::string format(const miutil::miTime& time, const std::string& format);
 
+  // process-wide, see miDate::setDefaultLanguage and FormatContext
   void setDefaultLanguage(const char* l) { Date.setDefaultLanguage(l);}
 
+private:
+  std::string formatInZone(const std::string&, const std::string& lang, bool utf8, const std::string& zone) const;
 };
 
 }
@@ -0,0 +1,67 @@
+
+#ifndef PUTOOLS_TESTTEMPDIR_H
+#define PUTOOLS_TESTTEMPDIR_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace putools_test {
+
+//! create or truncate a file with the given content
+inline void write_file(const std::string& path, const std::string& content = std::string())
+{
+  FILE* f = fopen(path.c_str(), "w");
+  if (f) {
+    fwrite(content.data(), 1, content.size(), f);
+    fclose(f);
+  }
+}
+
+//! create or truncate a file with size bytes
+inline void write_file(const std::string& path, size_t size)
+{
+  write_file(path, std::string(size, 'x'));
+}
+
+//! create or truncate an empty file
+inline void touch(const std::string& path)
+{
+  write_file(path);
+}
+
+/*! Temporary directory, removed with its content by the destructor.
+ *
+ * path is empty if the directory could not be made. It has no symbolic
+ * links, even if /tmp is one.
+ */
+struct TempDir {
+  std::string path;
+
+  TempDir()
+    {
+      char tmpl[] = "/tmp/putools_test_XXXXXX";
+      if (mkdtemp(tmpl)) {
+        char* rp = realpath(tmpl, 0);
+        path = rp ? rp : tmpl;
+        free(rp);
+      }
+    }
+
+  ~TempDir()
+    {
+      if (path.empty())
+        return;
+      const std::string cmd = "rm -rf '" + path + "'";
+      if (system(cmd.c_str()) != 0)
+        perror(cmd.c_str());
+    }
+
+private:
+  TempDir(const TempDir&);
+  TempDir& operator=(const TempDir&);
+};
+
+} // namespace putools_test
+
+#endif // PUTOOLS_TESTTEMPDIR_H
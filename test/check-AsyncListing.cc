@@ -0,0 +1,106 @@
+
+#include "AsyncListing.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <string>
+
+using namespace miutil;
+using namespace putools_test;
+
+namespace {
+void make_files(const std::string& dir, int n)
+{
+  for (int i=0; i<n; ++i) {
+    char name[32];
+    snprintf(name, sizeof(name), "/f%05d.dat", i);
+    touch(dir + name);
+  }
+  touch(dir + "/README");
+}
+} // namespace
+
+TEST(AsyncListingTest, Pull)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+  make_files(dir, 3000);
+
+  AsyncListing listing(dir, SCAN_NAMES, NameMatcher::suffix(".dat"));
+  listing.setMaxQueued(1);
+  listing.start();
+
+  std::set<std::string> names;
+  size_t chunks = 0;
+  DirEntries chunk;
+  while (listing.next(chunk) == AsyncListing::CHUNK) {
+    chunks += 1;
+    EXPECT_LE(chunk.size(), 1024u);
+    for (size_t i=0; i<chunk.size(); ++i)
+      names.insert(chunk.name(i));
+  }
+  EXPECT_EQ(3000u, names.size());
+  EXPECT_GE(chunks, 3u);
+  EXPECT_TRUE(listing.finished().get());
+  EXPECT_EQ(AsyncListing::END, listing.next(chunk, 0));
+}
+
+TEST(AsyncListingTest, Push)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  make_files(dir, 100);
+
+  size_t count = 0;
+  int done = -1;
+  AsyncListing listing(dir);
+  listing.start([&count](const DirEntries& chunk) { count += chunk.size(); },
+      [&done](bool ok) { done = ok ? 1 : 0; });
+  EXPECT_TRUE(listing.finished().get());
+  EXPECT_EQ(101u, count);
+  EXPECT_EQ(1, done);
+}
+
+TEST(AsyncListingTest, Cancel)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  make_files(dir, 3000);
+
+  AsyncListing listing(dir);
+  listing.setMaxQueued(1);
+  CancelToken token = listing.token();
+  listing.start();
+
+  DirEntries chunk;
+  ASSERT_EQ(AsyncListing::CHUNK, listing.next(chunk));
+  token.cancel();
+  EXPECT_FALSE(listing.finished().get());
+  EXPECT_EQ(AsyncListing::END, listing.next(chunk));
+}
+
+TEST(AsyncListingTest, Missing)
+{
+  AsyncListing listing("/nonexistent/putools");
+  listing.start();
+  DirEntries chunk;
+  EXPECT_EQ(AsyncListing::END, listing.next(chunk));
+  EXPECT_FALSE(listing.finished().get());
+}
+
+TEST(AsyncListingTest, DestroyWhileRunning)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  make_files(dir, 3000);
+
+  // nobody takes the chunks; the destructor must not hang
+  AsyncListing listing(dir);
+  listing.setMaxQueued(1);
+  listing.start();
+}
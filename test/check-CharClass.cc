@@ -0,0 +1,70 @@
+
+#include "CharClass.h"
+#include "miStringFunctions.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+
+using namespace miutil;
+
+TEST(CharClassTest, Members)
+{
+  CharClass cc(" \t");
+  EXPECT_EQ(2u, cc.size());
+  EXPECT_TRUE(cc.contains(' '));
+  EXPECT_TRUE(cc('\t'));
+  EXPECT_FALSE(cc.contains('x'));
+  EXPECT_FALSE(cc.contains(0));
+
+  cc.add(' ');
+  cc.add('\xff');
+  EXPECT_EQ(3u, cc.size());
+  EXPECT_TRUE(cc.contains('\xff'));
+
+  EXPECT_EQ(4u, CharClass::whitespace().size());
+  EXPECT_TRUE(CharClass::whitespace().contains('\r'));
+}
+
+TEST(CharClassTest, Find)
+{
+  const std::string text = "   ab\tcd    ";
+  const CharClass& ws = CharClass::whitespace();
+  EXPECT_EQ(3u, ws.find_first_not_of(text.data(), text.size()));
+  EXPECT_EQ(5u, ws.find_first_of(text.data(), text.size(), 3));
+  EXPECT_EQ(7u, ws.find_last_not_of(text.data(), text.size()));
+  EXPECT_EQ(CharClass::npos, ws.find_first_of(text.data(), text.size(), 99));
+  EXPECT_EQ(CharClass::npos, ws.find_first_not_of(text.data(), 3));
+  EXPECT_EQ(CharClass::npos, ws.find_last_not_of(text.data(), 3));
+  EXPECT_EQ(CharClass::npos, CharClass().find_first_of(text.data(), text.size()));
+  EXPECT_EQ(0u, CharClass().find_first_not_of(text.data(), text.size()));
+}
+
+// compare to std::string with long texts, so that the vector kernels
+// and the tails behind them are used, for small and large sets
+TEST(CharClassTest, SameAsString)
+{
+  const char* sets[] = { "", " ", " \r\t\n", ",;:", "abcdefgh", "abcdefghi", "0123456789 \t" };
+  std::mt19937 rng(42);
+  for (size_t s=0; s<sizeof(sets)/sizeof(sets[0]); ++s) {
+    const CharClass cc(sets[s]);
+    for (int n=0; n<200; ++n) {
+      std::string text(rng() % 100, 'x');
+      const size_t hits = rng() % 4;
+      for (size_t h=0; h<hits && !text.empty(); ++h)
+        text[rng() % text.size()] = (*sets[s] && (rng() % 2)) ? sets[s][rng() % strlen(sets[s])] : ' ';
+      if (n % 2)
+        for (size_t i=0; i<text.size(); ++i)
+          text[i] = (text[i] == 'x') ? sets[s][0] : 'x';
+      for (size_t pos=0; pos<=text.size() + 1; pos += 7) {
+        EXPECT_EQ(text.find_first_of(sets[s], pos), cc.find_first_of(text.data(), text.size(), pos))
+            << CharClass::kernel() << " set='" << sets[s] << "' text='" << text << "' pos=" << pos;
+        EXPECT_EQ(text.find_first_not_of(sets[s], pos), cc.find_first_not_of(text.data(), text.size(), pos))
+            << CharClass::kernel() << " set='" << sets[s] << "' text='" << text << "' pos=" << pos;
+      }
+      EXPECT_EQ(text.find_last_not_of(sets[s]), cc.find_last_not_of(text.data(), text.size()));
+    }
+  }
+}
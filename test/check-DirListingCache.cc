@@ -0,0 +1,223 @@
+
+#include "DirListingCache.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+namespace {
+// move the modification time back, so that it is not considered too recent
+void age(const std::string& path)
+{
+  struct timeval tv[2];
+  gettimeofday(&tv[0], 0);
+  tv[0].tv_sec -= 60;
+  tv[1] = tv[0];
+  utimes(path.c_str(), tv);
+}
+
+void check_cache(bool inotify)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+  write_file(dir + "/b.grb", "abc");
+  touch(dir + "/a.grb");
+  touch(dir + "/c.txt");
+  age(dir);
+
+  DirListingCache cache(inotify);
+  DirListingCache::Ptr l1 = cache.get(dir);
+  ASSERT_TRUE(bool(l1));
+  ASSERT_EQ(3u, l1->items.size());
+  EXPECT_EQ("a.grb", l1->items[0].name);
+  EXPECT_EQ("c.txt", l1->items[2].name);
+  ASSERT_TRUE(l1->find("b.grb") != 0);
+  EXPECT_EQ(3, l1->find("b.grb")->size);
+  EXPECT_EQ(DirEntries::TYPE_FILE, l1->find("b.grb")->type);
+  EXPECT_TRUE(l1->find("d.grb") == 0);
+  EXPECT_EQ(1u, cache.rescans());
+
+  // unchanged, served from memory, also with trailing '/'
+  EXPECT_EQ(l1, cache.get(dir));
+  EXPECT_EQ(l1, cache.get(dir + "/"));
+  EXPECT_EQ(1u, cache.rescans());
+
+  std::vector<std::string> names;
+  EXPECT_TRUE(cache.filenamesByExt(dir, "grb", names));
+  ASSERT_EQ(2u, names.size());
+  EXPECT_EQ("a.grb", names[0]);
+  EXPECT_EQ("b.grb", names[1]);
+  EXPECT_EQ(1u, cache.rescans());
+
+  unlink((dir + "/a.grb").c_str());
+  touch(dir + "/d.grb");
+  age(dir);
+  DirListingCache::Ptr l2 = cache.get(dir);
+  ASSERT_TRUE(bool(l2));
+  EXPECT_GT(l2->snapshot, l1->snapshot);
+  EXPECT_EQ(2u, cache.rescans());
+
+  DirListingCache::Diff diff;
+  ASSERT_TRUE(cache.diff(dir, l1->snapshot, diff));
+  ASSERT_EQ(1u, diff.added.size());
+  EXPECT_EQ("d.grb", diff.added[0].name);
+  ASSERT_EQ(1u, diff.removed.size());
+  EXPECT_EQ("a.grb", diff.removed[0].name);
+  EXPECT_TRUE(diff.modified.empty());
+
+  ASSERT_TRUE(cache.diff(dir, l2->snapshot, diff));
+  EXPECT_TRUE(diff.empty());
+
+  ASSERT_TRUE(cache.diff(dir, 0, diff));
+  EXPECT_EQ(3u, diff.added.size());
+
+  // the old listing is unchanged
+  EXPECT_EQ(3u, l1->items.size());
+  EXPECT_TRUE(l1->find("a.grb") != 0);
+}
+} // namespace
+
+TEST(DirListingCacheTest, Mtime)
+{
+  check_cache(false);
+}
+
+TEST(DirListingCacheTest, Inotify)
+{
+  DirListingCache probe(true);
+  if (!probe.usesInotify())
+    return;
+  check_cache(true);
+}
+
+TEST(DirListingCacheTest, InotifyModified)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  write_file(dir + "/a.txt", "a");
+
+  DirListingCache cache(true);
+  if (!cache.usesInotify())
+    return;
+  DirListingCache::Ptr l1 = cache.get(dir);
+  ASSERT_TRUE(bool(l1));
+
+  // written in place, the directory mtime does not change
+  write_file(dir + "/a.txt", "abcdef");
+  DirListingCache::Ptr l2 = cache.get(dir);
+  ASSERT_TRUE(bool(l2));
+  DirListingCache::Diff diff;
+  DirListingCache::diff(*l1, *l2, diff);
+  EXPECT_TRUE(diff.added.empty());
+  EXPECT_TRUE(diff.removed.empty());
+  ASSERT_EQ(1u, diff.modified.size());
+  EXPECT_EQ(6, diff.modified[0].size);
+}
+
+TEST(DirListingCacheTest, RecentDirectory)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  touch(dir + "/a.txt");
+
+  // just modified, so read again, but unchanged content keeps its snapshot
+  DirListingCache cache(false);
+  DirListingCache::Ptr l1 = cache.get(dir);
+  DirListingCache::Ptr l2 = cache.get(dir);
+  EXPECT_EQ(2u, cache.rescans());
+  EXPECT_EQ(l1, l2);
+}
+
+TEST(DirListingCacheTest, History)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+
+  DirListingCache cache(false);
+  cache.setHistory(2);
+  DirListingCache::Ptr l1 = cache.get(dir);
+  ASSERT_TRUE(bool(l1));
+  EXPECT_TRUE(l1->items.empty());
+  touch(dir + "/a");
+  DirListingCache::Ptr l2 = cache.get(dir);
+  touch(dir + "/b");
+  DirListingCache::Ptr l3 = cache.get(dir);
+  ASSERT_NE(l2->snapshot, l3->snapshot);
+
+  DirListingCache::Diff diff;
+  EXPECT_FALSE(cache.diff(dir, l1->snapshot, diff));
+  EXPECT_TRUE(cache.diff(dir, l2->snapshot, diff));
+  EXPECT_EQ(1u, diff.added.size());
+}
+
+TEST(DirListingCacheTest, Missing)
+{
+  DirListingCache cache;
+  EXPECT_FALSE(bool(cache.get("/nonexistent/putools")));
+  DirListingCache::Diff diff;
+  EXPECT_FALSE(cache.diff("/nonexistent/putools", 0, diff));
+}
+
+TEST(DirListingCacheTest, MaxDirectories)
+{
+  TempDir tmp;
+  const std::string a = tmp.path + "/a", b = tmp.path + "/b", c = tmp.path + "/c";
+  ASSERT_EQ(0, mkdir(a.c_str(), 0755));
+  ASSERT_EQ(0, mkdir(b.c_str(), 0755));
+  ASSERT_EQ(0, mkdir(c.c_str(), 0755));
+  age(a);
+  age(b);
+  age(c);
+
+  DirListingCache cache(false);
+  cache.setMaxDirectories(2);
+  EXPECT_EQ(2u, cache.maxDirectories());
+  cache.get(a);
+  cache.get(b);
+  cache.get(a);
+  EXPECT_EQ(2u, cache.rescans());
+
+  // b is the least recently used
+  cache.get(c);
+  cache.get(a);
+  EXPECT_EQ(3u, cache.rescans());
+  cache.get(b);
+  EXPECT_EQ(4u, cache.rescans());
+}
+
+TEST(DirListingCacheTest, Threads)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  for (int i=0; i<100; ++i)
+    touch(dir + "/f" + std::to_string(i));
+  age(dir);
+
+  // threads asking for the same directory wait for one read
+  DirListingCache cache;
+  std::vector<DirListingCache::Ptr> listings(8);
+  std::vector<std::thread> threads;
+  for (size_t i=0; i<listings.size(); ++i)
+    threads.push_back(std::thread([&cache, &dir, &listings, i]() {
+          listings[i] = cache.get(dir);
+        }));
+  for (size_t i=0; i<threads.size(); ++i)
+    threads[i].join();
+
+  EXPECT_EQ(1u, cache.rescans());
+  ASSERT_TRUE(bool(listings[0]));
+  EXPECT_EQ(100u, listings[0]->items.size());
+  for (size_t i=1; i<listings.size(); ++i)
+    EXPECT_EQ(listings[0], listings[i]);
+}
@@ -0,0 +1,104 @@
+
+#include "DirWalker.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+namespace {
+// 4 x 5 directories with 10 files each, plus a loop
+struct TempTree : TempDir {
+  TempTree()
+    {
+      if (path.empty())
+        return;
+      for (int a=0; a<4; ++a) {
+        const std::string da = path + "/d" + std::to_string(a);
+        mkdir(da.c_str(), 0755);
+        for (int b=0; b<5; ++b) {
+          const std::string db = da + "/e" + std::to_string(b);
+          mkdir(db.c_str(), 0755);
+          for (int f=0; f<10; ++f)
+            write_file(db + "/f" + std::to_string(f), f);
+        }
+      }
+      if (symlink("..", (path + "/d0/up").c_str()) != 0)
+        perror("symlink");
+    }
+};
+
+std::vector<std::string> paths(const std::vector<DirWalker::File>& files)
+{
+  std::vector<std::string> p;
+  for (size_t i=0; i<files.size(); ++i)
+    p.push_back(files[i].path);
+  std::sort(p.begin(), p.end());
+  return p;
+}
+} // namespace
+
+TEST(DirWalkerTest, Collect)
+{
+  TempTree tree;
+  ASSERT_FALSE(tree.path.empty());
+
+  std::vector<DirWalker::File> files1, files4;
+  DirWalker w1(1), w4(4);
+  ASSERT_TRUE(w1.collect(tree.path, files1));
+  ASSERT_TRUE(w4.collect(tree.path, files4));
+  // 4 + 20 directories, 200 files, 1 link
+  EXPECT_EQ(225u, files1.size());
+  EXPECT_EQ(paths(files1), paths(files4));
+  EXPECT_EQ(0u, w4.errors());
+
+  int64_t total = 0;
+  for (size_t i=0; i<files4.size(); ++i) {
+    if (files4[i].type == DirEntries::TYPE_FILE)
+      total += files4[i].size;
+    if (files4[i].path == tree.path + "/d0/up") {
+      EXPECT_EQ(DirEntries::TYPE_LINK, files4[i].type);
+    }
+  }
+  EXPECT_EQ(20 * 45, total);
+
+  EXPECT_FALSE(w4.collect(tree.path + "/missing", files4));
+}
+
+TEST(DirWalkerTest, Prune)
+{
+  TempTree tree;
+  ASSERT_FALSE(tree.path.empty());
+
+  DirWalker w(3);
+  std::vector<DirWalker::File> files;
+  w.setMaxDepth(0);
+  ASSERT_TRUE(w.collect(tree.path, files));
+  EXPECT_EQ(4u, files.size());
+
+  w.setMaxDepth(-1);
+  w.setDirectoryFilter([](const DirWalker::Entry& e) { return std::string(e.name) != "d1"; });
+  ASSERT_TRUE(w.collect(tree.path, files));
+  EXPECT_EQ(225u - 5 * 11, files.size());
+}
+
+TEST(DirWalkerTest, CallbackThrows)
+{
+  TempTree tree;
+  ASSERT_FALSE(tree.path.empty());
+
+  DirWalker w(2);
+  EXPECT_THROW(w.walk(tree.path, [](const DirWalker::Entry& e) {
+        if (e.depth == 2)
+          throw std::runtime_error("stop");
+      }), std::runtime_error);
+}
@@ -0,0 +1,129 @@
+
+#include "FileCatalog.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+TEST(FileCatalogTest, Update)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+
+  write_file(dir + "/ec_2015020100.grb", "abc");
+  write_file(dir + "/ec_2015020112.grb", "abcdef");
+  touch(dir + "/ec_2015020106.grb");
+  touch(dir + "/ec_2015029900.grb");
+  touch(dir + "/README");
+  mkdir((dir + "/ec_2015020118.grb").c_str(), 0755);
+
+  {
+    FileCatalog cat(dir, "ec_[yyyymmddHH].grb");
+    ASSERT_TRUE(cat.ok());
+    EXPECT_FALSE(cat.load());
+
+    bool changed = false;
+    ASSERT_TRUE(cat.update(false, changed));
+    EXPECT_TRUE(changed);
+    ASSERT_EQ(3u, cat.size());
+    EXPECT_EQ("ec_2015020100.grb", cat.entry(0).name);
+    EXPECT_EQ(3, cat.entry(0).size);
+    EXPECT_EQ("ec_2015020106.grb", cat.entry(1).name);
+    EXPECT_EQ(pack_time(2015, 2, 1, 12, 0, 0), cat.entry(2).time);
+    EXPECT_EQ(6, cat.entry(2).size);
+
+    ASSERT_TRUE(cat.update(false, changed));
+    EXPECT_FALSE(changed);
+
+    std::vector<FileCatalog::Entry> entries;
+    EXPECT_EQ(2u, cat.find(pack_time(2015, 2, 1, 3, 0, 0), pack_time(2015, 2, 1, 12, 0, 0), entries));
+    ASSERT_EQ(2u, entries.size());
+    EXPECT_EQ("ec_2015020106.grb", entries[0].name);
+    EXPECT_EQ("ec_2015020112.grb", entries[1].name);
+  }
+
+  touch(dir + "/ec_2015020109.grb");
+  unlink((dir + "/ec_2015020100.grb").c_str());
+
+  {
+    // a new catalog finds the index written above
+    FileCatalog cat(dir, "ec_[yyyymmddHH].grb");
+    ASSERT_TRUE(cat.load());
+    EXPECT_EQ(3u, cat.size());
+
+    bool changed = false;
+    ASSERT_TRUE(cat.update(false, changed));
+    EXPECT_TRUE(changed);
+
+    std::vector<packed_time> times;
+    cat.times(times);
+    ASSERT_EQ(3u, times.size());
+    EXPECT_EQ(pack_time(2015, 2, 1, 6, 0, 0), times[0]);
+    EXPECT_EQ(pack_time(2015, 2, 1, 9, 0, 0), times[1]);
+    EXPECT_EQ(pack_time(2015, 2, 1, 12, 0, 0), times[2]);
+  }
+
+  {
+    // a different pattern has its own index
+    FileCatalog cat(dir, "ec_[yyyymmdd]??.grb");
+    EXPECT_FALSE(cat.load());
+    ASSERT_TRUE(cat.update());
+    EXPECT_EQ(3u, cat.size());
+  }
+}
+
+TEST(FileCatalogTest, ReadOnlyIndex)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+  touch(dir + "/obs_20150201.txt");
+
+  FileCatalog cat(dir, "obs_[yyyymmdd].txt", dir + "/no/such/dir/index");
+  ASSERT_TRUE(cat.update());
+  EXPECT_EQ(1u, cat.size());
+  EXPECT_EQ(pack_time(2015, 2, 1, 12, 0, 0), cat.entry(0).time);
+
+  EXPECT_FALSE(FileCatalog(dir, "no_time.txt").ok());
+  EXPECT_FALSE(FileCatalog(dir + "/missing", "obs_[yyyymmdd].txt").update());
+}
+
+TEST(FileCatalogTest, CorruptIndex)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+  touch(dir + "/obs_20150201.txt");
+  const std::string index = dir + "/index";
+  {
+    FileCatalog cat(dir, "obs_[yyyymmdd].txt", index);
+    ASSERT_TRUE(cat.update());
+  }
+  FileCatalog cat(dir, "obs_[yyyymmdd].txt", index);
+  ASSERT_TRUE(cat.load());
+
+  // the name offset of the only record, just before the name
+  struct stat st;
+  ASSERT_EQ(0, stat(index.c_str(), &st));
+  const long name_offset = st.st_size - 16 - 2 * sizeof(uint32_t);
+  FILE* f = fopen(index.c_str(), "r+");
+  ASSERT_TRUE(f != 0);
+  const uint32_t bad = 1000;
+  ASSERT_EQ(0, fseek(f, name_offset, SEEK_SET));
+  ASSERT_EQ(1u, fwrite(&bad, sizeof(bad), 1, f));
+  fclose(f);
+
+  EXPECT_FALSE(cat.load());
+  EXPECT_EQ(0u, cat.size());
+  ASSERT_TRUE(cat.update());
+  EXPECT_EQ(1u, cat.size());
+}
@@ -0,0 +1,52 @@
+
+#include "FilePrefetcher.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+TEST(FilePrefetcherTest, Schedule)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+
+  write_file(dir + "/ec_2015020100.grb", 1000);
+  write_file(dir + "/ec_2015020106.grb", 3 << 20);
+  write_file(dir + "/ec_2015020112.grb", 0);
+
+  for (int m=0; m<2; ++m) {
+    FilePrefetcher fp(dir, 2, m == 0 ? FilePrefetcher::READ : FilePrefetcher::ADVISE);
+    EXPECT_TRUE(fp.addPattern("ec_[yyyymmddHH].grb"));
+    EXPECT_FALSE(fp.addPattern("no_time"));
+
+    // the current time is not prefetched, the missing 18 UTC file is skipped
+    fp.schedule(TimeAxis(pack_time(2015, 2, 1, 0, 0, 0), 6*3600, 8), pack_time(2015, 2, 1, 0, 0, 0), 3);
+    fp.wait();
+    EXPECT_EQ(2u, fp.filesDone());
+    EXPECT_EQ(size_t(3 << 20), fp.bytesDone());
+  }
+
+  FilePrefetcher fp(dir, 1);
+  fp.addPattern("ec_[yyyymmddHH].grb");
+  fp.setMaxQueued(1);
+  std::vector<packed_time> times;
+  times.push_back(pack_time(2015, 2, 1, 0, 0, 0));
+  times.push_back(pack_time(2015, 2, 1, 6, 0, 0));
+  fp.schedule(times);
+  fp.wait();
+  EXPECT_EQ(1u, fp.filesDone());
+  EXPECT_EQ(1000u, fp.bytesDone());
+
+  fp.schedule(times);
+  fp.cancel();
+  fp.wait();
+  EXPECT_LE(fp.filesDone(), 2u);
+}
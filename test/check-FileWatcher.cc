@@ -0,0 +1,144 @@
+
+#include "FileWatcher.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+namespace {
+// collect events until count are there or nothing more arrives
+std::vector<FileWatcher::Event> collect(FileWatcher& fw, size_t count)
+{
+  std::vector<FileWatcher::Event> events;
+  while (events.size() < count && fw.wait(events, 2000) > 0)
+    ;
+  return events;
+}
+} // namespace
+
+TEST(FileWatcherTest, Inotify)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+  touch(dir.path + "/ec_2015020100.grb");
+
+  FileWatcher fw;
+  if (!fw.usesInotify())
+    return; // covered by the polling test
+  EXPECT_EQ(0, fw.addPattern("ec_[yyyymmddHH].grb"));
+  EXPECT_EQ(-1, fw.addPattern("no_time"));
+  ASSERT_TRUE(fw.addDirectory(dir.path, true));
+  // already watched, also by another path
+  EXPECT_FALSE(fw.addDirectory(dir.path, true));
+  EXPECT_FALSE(fw.addDirectory(dir.path + "/.", true));
+
+  std::vector<FileWatcher::Event> events = collect(fw, 1);
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(FileWatcher::ARRIVED, events[0].type);
+  EXPECT_EQ("ec_2015020100.grb", events[0].name);
+
+  touch(dir.path + "/README");
+  touch(dir.path + "/ec_2015020106.grb");
+  events = collect(fw, 2);
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(FileWatcher::ARRIVED, events[0].type);
+  EXPECT_EQ(FileWatcher::CLOSED_WRITE, events[1].type);
+  EXPECT_EQ("ec_2015020106.grb", events[1].name);
+  EXPECT_EQ(dir.path, events[1].directory);
+  EXPECT_EQ(pack_time(2015, 2, 1, 6, 0, 0), events[1].time);
+
+  unlink((dir.path + "/ec_2015020100.grb").c_str());
+  events = collect(fw, 1);
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(FileWatcher::REMOVED, events[0].type);
+
+  events.clear();
+  EXPECT_EQ(0u, fw.wait(events, 0));
+}
+
+TEST(FileWatcherTest, Polling)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+  touch(dir.path + "/ec_2015020100.grb");
+
+  FileWatcher fw(false);
+  EXPECT_FALSE(fw.usesInotify());
+  fw.setPollInterval(10);
+  fw.addPattern("ec_[yyyymmddHH].grb");
+  ASSERT_TRUE(fw.addDirectory(dir.path));
+  EXPECT_FALSE(fw.addDirectory(dir.path + "/missing"));
+
+  touch(dir.path + "/ec_2015020106.grb");
+  unlink((dir.path + "/ec_2015020100.grb").c_str());
+  std::vector<FileWatcher::Event> events = collect(fw, 2);
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(FileWatcher::ARRIVED, events[0].type);
+  EXPECT_EQ("ec_2015020106.grb", events[0].name);
+  EXPECT_EQ(FileWatcher::REMOVED, events[1].type);
+  EXPECT_EQ("ec_2015020100.grb", events[1].name);
+}
+
+TEST(FileWatcherTest, Callback)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::string> names;
+
+  FileWatcher fw;
+  fw.setPollInterval(10);
+  fw.addPattern("ec_[yyyymmddHH].grb");
+  ASSERT_TRUE(fw.addDirectory(dir.path));
+  fw.start([&](const FileWatcher::Event& e) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (e.type == FileWatcher::ARRIVED)
+        names.push_back(e.name);
+      cv.notify_all();
+    });
+
+  touch(dir.path + "/ec_2015020112.grb");
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait_for(lock, std::chrono::seconds(5), [&]() { return !names.empty(); });
+  }
+  fw.stop();
+  ASSERT_EQ(1u, names.size());
+  EXPECT_EQ("ec_2015020112.grb", names[0]);
+}
+
+TEST(FileWatcherTest, RenameOver)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+  const std::string file = dir.path + "/ec_2015020100.grb";
+  touch(file);
+
+  for (int inotify=0; inotify<2; ++inotify) {
+    FileWatcher fw(inotify);
+    if (inotify && !fw.usesInotify())
+      continue;
+    fw.setPollInterval(10);
+    fw.addPattern("ec_[yyyymmddHH].grb");
+    ASSERT_TRUE(fw.addDirectory(dir.path));
+
+    // deliver new contents by writing a temporary file and renaming it
+    write_file(dir.path + "/incoming.tmp", "new");
+    ASSERT_EQ(0, rename((dir.path + "/incoming.tmp").c_str(), file.c_str()));
+    std::vector<FileWatcher::Event> events = collect(fw, 1);
+    ASSERT_EQ(1u, events.size()) << "inotify=" << inotify;
+    EXPECT_EQ(inotify ? FileWatcher::ARRIVED : FileWatcher::CLOSED_WRITE, events[0].type);
+    EXPECT_EQ("ec_2015020100.grb", events[0].name);
+  }
+}
@@ -0,0 +1,83 @@
+
+#include "Glob.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+namespace {
+// a tree like /data/{ec,arome}/YYYY/MM/...
+void make_tree(const std::string& d)
+{
+  const char* dirs[] = { "/ec", "/ec/2015", "/ec/2015/02", "/arome", "/arome/2015", "/hirlam", "/ec/.hidden" };
+  for (size_t i=0; i<sizeof(dirs)/sizeof(dirs[0]); ++i)
+    mkdir((d + dirs[i]).c_str(), 0755);
+  touch(d + "/ec/ec_2015.grb");
+  touch(d + "/ec/2015/02/ec_2015020100.grb");
+  touch(d + "/ec/2015/02/ec_x.grb");
+  touch(d + "/ec/.hidden/ec_2015020100.grb");
+  touch(d + "/arome/2015/arome_2015020100.grb");
+  touch(d + "/arome/2015/arome_2015020100.nc");
+  touch(d + "/hirlam/hirlam_2015020100.grb");
+  touch(d + "/ec/.ec_2015.grb");
+}
+} // namespace
+
+TEST(GlobTest, Braces)
+{
+  EXPECT_EQ(1u, Glob("abc").alternatives().size());
+  const Glob g("/data/{ec,arome/{a,b}}/x{1,2}");
+  ASSERT_EQ(6u, g.alternatives().size());
+  EXPECT_EQ("/data/ec/x1", g.alternatives()[0]);
+  EXPECT_EQ("/data/ec/x2", g.alternatives()[1]);
+  EXPECT_EQ("/data/arome/a/x1", g.alternatives()[2]);
+  EXPECT_EQ("/data/arome/b/x2", g.alternatives()[5]);
+
+  // literal braces
+  ASSERT_EQ(1u, Glob("a{b}c").alternatives().size());
+  ASSERT_EQ(1u, Glob("a{b,c").alternatives().size());
+  ASSERT_EQ(1u, Glob("a\\{b,c}").alternatives().size());
+  ASSERT_EQ(2u, Glob("{,x}").alternatives().size());
+}
+
+TEST(GlobTest, Expand)
+{
+  TempDir tmp;
+  const std::string& d = tmp.path;
+  ASSERT_FALSE(d.empty());
+  make_tree(d);
+
+  std::vector<std::string> paths;
+  ASSERT_EQ(3u, expand_glob(d + "/{ec,arome}/**/*_[0-9]*.grb", paths));
+  EXPECT_EQ(d + "/arome/2015/arome_2015020100.grb", paths[0]);
+  EXPECT_EQ(d + "/ec/2015/02/ec_2015020100.grb", paths[1]);
+  EXPECT_EQ(d + "/ec/ec_2015.grb", paths[2]);
+
+  EXPECT_EQ(2u, expand_glob(d + "/*/2015/", paths));
+  EXPECT_EQ(d + "/arome/2015/", paths[0]);
+
+  EXPECT_EQ(1u, expand_glob(d + "/ec/.*.grb", paths));
+  EXPECT_EQ(1u, expand_glob(d + "/ec/.hidden/*", paths));
+  EXPECT_EQ(1u, expand_glob(d + "/hirlam/hirlam_2015020100.grb", paths));
+  EXPECT_EQ(0u, expand_glob(d + "/hirlam/missing.grb", paths));
+  EXPECT_EQ(0u, expand_glob(d + "/missing/*", paths));
+
+  // everything below, without hidden entries
+  EXPECT_EQ(5u, expand_glob(d + "/ec/**", paths));
+
+  // relative patterns give relative paths
+  char cwd[4096];
+  ASSERT_TRUE(getcwd(cwd, sizeof(cwd)) != 0);
+  ASSERT_EQ(0, chdir(d.c_str()));
+  EXPECT_EQ(1u, expand_glob("*/2015/*.grb", paths));
+  EXPECT_EQ("arome/2015/arome_2015020100.grb", paths[0]);
+  EXPECT_EQ(0, chdir(cwd));
+}
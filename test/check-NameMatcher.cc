@@ -0,0 +1,119 @@
+
+#include "NameMatcher.h"
+#include "miDirtools.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <fnmatch.h>
+#include <regex.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace miutil;
+using namespace putools_test;
+
+namespace {
+const char* const NAMES[] = {
+  "", "a", "ab", "abc", "abcabc", "ec_2015020100.grb", "ec_2015020100.grb.tmp",
+  "hirlam_2015.nc", "x.nc", ".nc", "nc", "a.b.c", "file.", "file..", "a*b", "a?b",
+  "a[b", "a\\b", "abab", "aXbXc", "README", "ec_.grb", "ec_2015.grib"
+};
+const size_t N_NAMES = sizeof(NAMES) / sizeof(NAMES[0]);
+} // namespace
+
+TEST(NameMatcherTest, Simple)
+{
+  EXPECT_TRUE(NameMatcher().match("anything"));
+  EXPECT_TRUE(NameMatcher::prefix("ec_").match("ec_2015.grb"));
+  EXPECT_FALSE(NameMatcher::prefix("ec_").match("e"));
+  EXPECT_TRUE(NameMatcher::suffix(".grb").match("ec_2015.grb"));
+  EXPECT_FALSE(NameMatcher::suffix(".grb").match("ec_2015.grb.tmp"));
+}
+
+TEST(NameMatcherTest, Extension)
+{
+  const NameMatcher m = NameMatcher::extension("nc");
+  EXPECT_TRUE(m.match("x.nc"));
+  EXPECT_TRUE(m.match(".nc"));
+  EXPECT_TRUE(m.match("a.b.nc"));
+  EXPECT_FALSE(m.match("x.nc4"));
+  EXPECT_FALSE(m.match("xnc"));
+  // quirks kept from getFilenamesByExt
+  EXPECT_TRUE(m.match("nc"));
+  EXPECT_TRUE(m.match("x.nc."));
+  EXPECT_TRUE(NameMatcher::extension("").match("x.."));
+}
+
+TEST(NameMatcherTest, GlobSameAsFnmatch)
+{
+  const char* const globs[] = {
+    "*", "a*", "*c", "a*c", "ab*ab", "*ab*", "ec_*.grb", "ec_??????????.grb", "ec_[0-9]*.grb",
+    "a\\*b", "a?b", "a[b", "*.nc", "abc", "", "a**b*", "[!a]*", "*.[gn]*"
+  };
+  for (size_t g=0; g<sizeof(globs)/sizeof(globs[0]); ++g) {
+    const NameMatcher m = NameMatcher::glob(globs[g]);
+    ASSERT_TRUE(m.ok());
+    for (size_t n=0; n<N_NAMES; ++n) {
+      EXPECT_EQ(fnmatch(globs[g], NAMES[n], 0) == 0, m.match(NAMES[n]))
+          << "glob='" << globs[g] << "' name='" << NAMES[n] << "'";
+    }
+  }
+}
+
+TEST(NameMatcherTest, RegexpSameAsRegexec)
+{
+  const char* const regexps[] = {
+    "abc", "^abc", "abc$", "^abc$", "^ab*c", "ab+c", "ab?c", "a.c", "^ec_[0-9]{10}\\.grb$",
+    "grb$", "\\.nc$", "^(ab)+$", "a|x", "^a|c$", "ab{0,2}", "X", "^a\\*b$", "[.]nc$",
+    "^hirlam_.*\\.nc$", "(ec|hirlam)_", "a\\wb", "^$", ".", "c$"
+  };
+  for (size_t r=0; r<sizeof(regexps)/sizeof(regexps[0]); ++r) {
+    regex_t re;
+    ASSERT_EQ(0, regcomp(&re, regexps[r], REG_EXTENDED | REG_NOSUB)) << regexps[r];
+    const NameMatcher m = NameMatcher::regexp(regexps[r]);
+    ASSERT_TRUE(m.ok());
+    for (size_t n=0; n<N_NAMES; ++n) {
+      EXPECT_EQ(regexec(&re, NAMES[n], 0, 0, 0) == 0, m.match(NAMES[n]))
+          << "regexp='" << regexps[r] << "' name='" << NAMES[n] << "'";
+    }
+    regfree(&re);
+  }
+}
+
+TEST(NameMatcherTest, BadRegexp)
+{
+  const NameMatcher m = NameMatcher::regexp("a(b");
+  EXPECT_FALSE(m.ok());
+  EXPECT_FALSE(m.match("a(b"));
+}
+
+TEST(NameMatcherTest, ScanDirectory)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+  touch(dir + "/ec_2015020100.grb");
+  touch(dir + "/ec_2015020112.grb");
+  touch(dir + "/ec_2015020112.grb.tmp");
+  touch(dir + "/hirlam.nc");
+  touch(dir + "/README");
+
+  DirEntries entries;
+  ASSERT_TRUE(scan_directory(dir, SCAN_SIZE, NameMatcher::glob("ec_*.grb"), entries));
+  EXPECT_EQ(2u, entries.size());
+
+  std::vector<std::string> names;
+  ASSERT_TRUE(getFilenamesByExt(dir, "nc", names));
+  ASSERT_EQ(1u, names.size());
+  EXPECT_EQ("hirlam.nc", names[0]);
+
+  names.clear();
+  ASSERT_TRUE(getFilenames(dir, NameMatcher::regexp("^ec_[0-9]+\\.grb$"), names));
+  EXPECT_EQ(2u, names.size());
+
+  names.clear();
+  EXPECT_FALSE(getFilenames(dir, NameMatcher::regexp("("), names));
+}
@@ -0,0 +1,110 @@
+
+#include "PathNormalizer.h"
+#include "miDirtools.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+namespace {
+std::string normalized(std::string path)
+{
+  normalize_path(path);
+  return path;
+}
+} // namespace
+
+TEST(PathNormalizerTest, Lexical)
+{
+  EXPECT_EQ("", normalized(""));
+  EXPECT_EQ("/", normalized("/"));
+  EXPECT_EQ("/", normalized("//"));
+  EXPECT_EQ("/", normalized("/.."));
+  EXPECT_EQ("/a/b", normalized("/a//b/"));
+  EXPECT_EQ("/a/c", normalized("/a/./b/../c"));
+  EXPECT_EQ("/c", normalized("/a/../../b/../c"));
+  EXPECT_EQ(".", normalized("."));
+  EXPECT_EQ(".", normalized("a/.."));
+  EXPECT_EQ("..", normalized("a/../.."));
+  EXPECT_EQ("../../b", normalized("../../a/../b"));
+  EXPECT_EQ("a/b", normalized("./a/./b/."));
+  EXPECT_EQ("...", normalized("..."));
+  EXPECT_EQ("/a/..b", normalized("/a/..b"));
+}
+
+TEST(PathNormalizerTest, Hardpath)
+{
+  const std::string cwd = current_directory();
+  ASSERT_FALSE(cwd.empty());
+  EXPECT_EQ(cwd + "/", hardpath(""));
+  EXPECT_EQ("/usr/local", hardpath("/usr/local"));
+  EXPECT_EQ(cwd + "/puTools", hardpath("puTools"));
+  EXPECT_EQ(cwd + "/b", hardpath("a/../b/"));
+}
+
+TEST(PathNormalizerTest, ChangeDirectory)
+{
+  TempDir tmp;
+  ASSERT_FALSE(tmp.path.empty());
+  const std::string old = current_directory();
+  ASSERT_TRUE(change_directory(tmp.path));
+  EXPECT_EQ(tmp.path, current_directory());
+
+  // chdir without telling the cache is noticed, too
+  ASSERT_EQ(0, chdir(old.c_str()));
+  EXPECT_EQ(old, current_directory());
+}
+
+TEST(PathNormalizerTest, Batch)
+{
+  PathNormalizer pn;
+  std::vector<std::string> paths;
+  paths.push_back("x/y/../z");
+  paths.push_back("/abs//path/");
+  paths.push_back("");
+  pn.normalize(paths);
+  EXPECT_EQ(pn.cwd() + "/x/z", paths[0]);
+  EXPECT_EQ("/abs/path", paths[1]);
+  EXPECT_EQ(pn.cwd(), paths[2]);
+}
+
+TEST(PathNormalizerTest, ResolveLinks)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+  mkdir((dir + "/real").c_str(), 0755);
+  mkdir((dir + "/real/sub").c_str(), 0755);
+  ASSERT_EQ(0, symlink("real/sub", (dir + "/link").c_str()));
+
+  // lexically, link/.. is dir; physically it is real
+  std::string p = dir + "/link/../file";
+  PathNormalizer lexical;
+  lexical.normalize(p);
+  EXPECT_EQ(dir + "/file", p);
+
+  PathNormalizer physical(true);
+  p = dir + "/link/../file";
+  physical.normalize(p);
+  EXPECT_EQ(dir + "/real/file", p);
+
+  p = dir + "/link/file";
+  physical.normalize(p);
+  EXPECT_EQ(dir + "/real/sub/file", p);
+
+  // the last component is kept, missing directories are lexical
+  p = dir + "/link";
+  physical.normalize(p);
+  EXPECT_EQ(dir + "/link", p);
+  p = dir + "/missing/../x";
+  physical.normalize(p);
+  EXPECT_EQ(dir + "/x", p);
+}
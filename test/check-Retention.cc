@@ -0,0 +1,137 @@
+
+#include "Retention.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+namespace {
+bool exists(const std::string& path)
+{
+  return access(path.c_str(), F_OK) == 0;
+}
+
+// ec_2015020100.grb ... one per day
+std::string ec_name(int day)
+{
+  char name[32];
+  snprintf(name, sizeof(name), "ec_201502%02d00.grb", day);
+  return name;
+}
+} // namespace
+
+TEST(RetentionTest, Rules)
+{
+  Retention r("/tmp");
+  EXPECT_EQ(-1, r.addRule("no_time.grb", 2));
+  EXPECT_EQ(-1, r.addRule("ec_[yyyymmddHH].grb", 0, Retention::NO_MAX_AGE));
+  EXPECT_EQ(0, r.addRule("ec_[yyyymmddHH].grb", 2));
+  EXPECT_EQ(1, r.addRule("hirlam_[yyyymmddHH].nc", 0, 3600));
+  EXPECT_EQ(2u, r.rules());
+}
+
+TEST(RetentionTest, DryRun)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+  for (int day=1; day<=6; ++day)
+    touch(dir.path + "/" + ec_name(day));
+  touch(dir.path + "/hirlam_2015020100.nc");
+  touch(dir.path + "/hirlam_2015020512.nc");
+  touch(dir.path + "/README");
+  ASSERT_EQ(0, mkdir((dir.path + "/ec_2015010100.grb").c_str(), 0700));
+
+  Retention r(dir.path);
+  ASSERT_EQ(0, r.addRule("ec_[yyyymmddHH].grb", 2));
+  ASSERT_EQ(1, r.addRule("hirlam_[yyyymmddHH].nc", 0, 24*3600));
+
+  const packed_time now = pack_time(2015, 2, 6, 0, 0, 0);
+  Retention::Report report;
+  ASSERT_TRUE(r.run(now, true, report));
+  EXPECT_EQ(1u, report.ignored);
+  EXPECT_TRUE(report.errors.empty());
+
+  ASSERT_EQ(3u, report.kept.size());
+  EXPECT_EQ(ec_name(6), report.kept[0].name);
+  EXPECT_EQ(ec_name(5), report.kept[1].name);
+  EXPECT_EQ("hirlam_2015020512.nc", report.kept[2].name);
+  EXPECT_EQ(1, report.kept[2].rule);
+
+  ASSERT_EQ(5u, report.deleted.size());
+  EXPECT_EQ(ec_name(4), report.deleted[0].name);
+  EXPECT_EQ(pack_time(2015, 2, 4, 0, 0, 0), report.deleted[0].time);
+  EXPECT_EQ(ec_name(1), report.deleted[3].name);
+  EXPECT_EQ("hirlam_2015020100.nc", report.deleted[4].name);
+
+  // nothing deleted
+  for (size_t i=0; i<report.deleted.size(); ++i)
+    EXPECT_TRUE(exists(dir.path + "/" + report.deleted[i].name));
+}
+
+TEST(RetentionTest, NewestOrAge)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+  for (int day=1; day<=6; ++day)
+    touch(dir.path + "/" + ec_name(day));
+
+  // keeps the newest one, and everything from the last three days
+  Retention r(dir.path);
+  ASSERT_EQ(0, r.addRule("ec_[yyyymmddHH].grb", 1, 3*24*3600));
+
+  Retention::Report report;
+  ASSERT_TRUE(r.run(pack_time(2015, 2, 6, 0, 0, 0), false, report));
+  EXPECT_EQ(4u, report.kept.size());
+  EXPECT_EQ(2u, report.deleted.size());
+  EXPECT_TRUE(report.errors.empty());
+  EXPECT_FALSE(exists(dir.path + "/" + ec_name(1)));
+  EXPECT_FALSE(exists(dir.path + "/" + ec_name(2)));
+  EXPECT_TRUE(exists(dir.path + "/" + ec_name(3)));
+
+  // far in the future, the newest one is still kept
+  ASSERT_TRUE(r.run(pack_time(2016, 1, 1, 0, 0, 0), false, report));
+  ASSERT_EQ(1u, report.kept.size());
+  EXPECT_EQ(ec_name(6), report.kept[0].name);
+  EXPECT_EQ(3u, report.deleted.size());
+  EXPECT_TRUE(exists(dir.path + "/" + ec_name(6)));
+  EXPECT_FALSE(exists(dir.path + "/" + ec_name(5)));
+}
+
+TEST(RetentionTest, Parallel)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+  const int count = 1000;
+  for (int i=0; i<count; ++i) {
+    char name[32];
+    snprintf(name, sizeof(name), "obs_20150101%02d%02d.dat", i / 60, i % 60);
+    touch(dir.path + "/" + name);
+  }
+
+  Retention r(dir.path);
+  ASSERT_EQ(0, r.addRule("obs_[yyyymmddHHMM].dat", 10));
+
+  Retention::Report report;
+  ASSERT_TRUE(r.run(pack_time(2015, 1, 1, 0, 0, 0), false, report, 4));
+  EXPECT_EQ(10u, report.kept.size());
+  EXPECT_TRUE(report.errors.empty());
+  EXPECT_EQ(size_t(count - 10), report.deleted.size());
+  EXPECT_TRUE(exists(dir.path + "/obs_201501011639.dat"));  // i = 999
+  EXPECT_FALSE(exists(dir.path + "/obs_201501011629.dat"));
+}
+
+TEST(RetentionTest, MissingDirectory)
+{
+  Retention r("/nonexistent/putools/retention");
+  ASSERT_EQ(0, r.addRule("ec_[yyyymmddHH].grb", 1));
+  Retention::Report report;
+  EXPECT_FALSE(r.run(0, true, report));
+}
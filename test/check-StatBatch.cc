@@ -0,0 +1,118 @@
+
+#include "StatBatch.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+namespace {
+// names 0..n-1, every third missing, file i has size i % 7
+void make_files(const std::string& dir, size_t n, std::vector<std::string>& names)
+{
+  names.clear();
+  for (size_t i=0; i<n; ++i) {
+    char name[32];
+    snprintf(name, sizeof(name), "f%05d", int(i));
+    names.push_back(name);
+    if (i % 3 != 0)
+      write_file(dir + "/" + name, i % 7);
+  }
+}
+
+void check_stats(const std::vector<std::string>& names, const std::vector<FileStat>& stats)
+{
+  ASSERT_EQ(names.size(), stats.size());
+  for (size_t i=0; i<names.size(); ++i) {
+    if (i % 3 == 0) {
+      EXPECT_EQ(ENOENT, stats[i].error) << names[i];
+    } else {
+      EXPECT_EQ(0, stats[i].error) << names[i];
+      EXPECT_EQ(DirEntries::TYPE_FILE, stats[i].type);
+      EXPECT_EQ(int64_t(i % 7), stats[i].size) << names[i];
+      EXPECT_NE(0, stats[i].mtime);
+    }
+  }
+}
+} // namespace
+
+TEST(StatBatchTest, IoUringOrFallback)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+  std::vector<std::string> names;
+  make_files(dir, 1000, names);
+
+  StatBatch batch;
+  std::vector<FileStat> stats;
+  EXPECT_TRUE(batch.stat(dir, names, stats));
+  check_stats(names, stats);
+
+  // again with the same ring, and with full paths
+  std::vector<std::string> paths(names);
+  for (size_t i=0; i<paths.size(); ++i)
+    paths[i] = dir + "/" + paths[i];
+  batch.stat(paths, stats);
+  check_stats(names, stats);
+}
+
+TEST(StatBatchTest, Threads)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  std::vector<std::string> names;
+  make_files(dir, 500, names);
+
+  StatBatch batch(false, 4);
+  EXPECT_FALSE(batch.usesIoUring());
+  std::vector<FileStat> stats;
+  EXPECT_TRUE(batch.stat(dir, names, stats));
+  check_stats(names, stats);
+
+  // the same threads again
+  stats.clear();
+  EXPECT_TRUE(batch.stat(dir, names, stats));
+  check_stats(names, stats);
+
+  // small batches
+  names.resize(5);
+  EXPECT_TRUE(batch.stat(dir, names, stats));
+  check_stats(names, stats);
+}
+
+TEST(StatBatchTest, Types)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  write_file(dir + "/file", 3);
+  mkdir((dir + "/dir").c_str(), 0755);
+  ASSERT_EQ(0, symlink("file", (dir + "/link").c_str()));
+
+  std::vector<std::string> names;
+  names.push_back("file");
+  names.push_back("dir");
+  names.push_back("link");
+  std::vector<FileStat> stats;
+  StatBatch batch;
+  ASSERT_TRUE(batch.stat(dir, names, stats));
+  EXPECT_EQ(DirEntries::TYPE_FILE, stats[0].type);
+  EXPECT_EQ(DirEntries::TYPE_DIR, stats[1].type);
+  EXPECT_EQ(DirEntries::TYPE_FILE, stats[2].type);
+  EXPECT_EQ(stats[0].inode, stats[2].inode);
+
+  ASSERT_TRUE(batch.stat(dir, names, stats, false));
+  EXPECT_EQ(DirEntries::TYPE_LINK, stats[2].type);
+
+  EXPECT_FALSE(batch.stat(dir + "/missing", names, stats));
+  ASSERT_EQ(3u, stats.size());
+  EXPECT_EQ(ENOENT, stats[0].error);
+}
@@ -0,0 +1,132 @@
+
+#include "TimeCache.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+using namespace miutil;
+
+namespace {
+struct Loader {
+  std::shared_ptr<std::atomic<int> > calls;
+  Loader() : calls(std::make_shared<std::atomic<int> >(0)) { }
+  std::shared_ptr<const int> operator()(packed_time t)
+    {
+      *calls += 1;
+      if (t < 0)
+        return std::shared_ptr<const int>();
+      return std::make_shared<const int>(t / 60);
+    }
+};
+} // namespace
+
+TEST(TimeCacheTest, GetAndEvict)
+{
+  Loader loader;
+  TimeCache<int> cache(3 * sizeof(int), loader);
+
+  ASSERT_TRUE(cache.get(600) != 0);
+  EXPECT_EQ(10, *cache.get(600));
+  EXPECT_EQ(1, *loader.calls);
+
+  EXPECT_FALSE(cache.get(-60));
+  EXPECT_FALSE(cache.find(-60));
+
+  cache.setCursor(600);
+  cache.get(0);
+  cache.get(1200);
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_EQ(3 * sizeof(int), cache.memoryUsed());
+
+  // over budget, 0 is farther from the cursor than 1800
+  cache.setCursor(1200);
+  cache.get(1800);
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_FALSE(cache.find(0));
+  EXPECT_TRUE(cache.find(600) != 0);
+  EXPECT_TRUE(cache.find(1800) != 0);
+
+  cache.setCursor(0);
+  cache.get(60);
+  EXPECT_FALSE(cache.find(1800));
+}
+
+TEST(TimeCacheTest, Prefetch)
+{
+  Loader loader;
+  TimeCache<int> cache(100 * sizeof(int), loader);
+
+  const TimeAxis axis(0, 60, 10);
+  cache.setCursor(120);
+  cache.prefetch(axis, 3);
+  cache.waitForPrefetch();
+
+  EXPECT_FALSE(cache.find(120));
+  EXPECT_EQ(3, *cache.find(180));
+  EXPECT_EQ(5, *cache.find(300));
+  EXPECT_FALSE(cache.find(360));
+  EXPECT_EQ(3, *loader.calls);
+
+  cache.get(240);
+  EXPECT_EQ(3, *loader.calls);
+}
+
+namespace {
+// loader blocking until released, counting the loads per time
+struct GateLoader {
+  struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool open;
+    std::map<packed_time, int> calls;
+    State() : open(false) { }
+  };
+  std::shared_ptr<State> state;
+  GateLoader() : state(std::make_shared<State>()) { }
+  std::shared_ptr<const int> operator()(packed_time t)
+    {
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->calls[t] += 1;
+      state->cv.notify_all();
+      state->cv.wait(lock, [this]() { return state->open; });
+      return std::make_shared<const int>(t / 60);
+    }
+};
+} // namespace
+
+TEST(TimeCacheTest, PrefetchAgain)
+{
+  GateLoader loader;
+  TimeCache<int> cache(100 * sizeof(int), loader);
+
+  std::vector<packed_time> upcoming;
+  upcoming.push_back(60);
+  upcoming.push_back(120);
+  cache.prefetch(upcoming);
+  {
+    std::unique_lock<std::mutex> lock(loader.state->mutex);
+    loader.state->cv.wait(lock, [&]() { return !loader.state->calls.empty(); });
+  }
+
+  // next animation step while 60 is loading
+  upcoming.push_back(180);
+  cache.prefetch(upcoming);
+  {
+    std::lock_guard<std::mutex> lock(loader.state->mutex);
+    loader.state->open = true;
+    loader.state->cv.notify_all();
+  }
+  cache.waitForPrefetch();
+
+  EXPECT_EQ(1, *cache.find(60));
+  EXPECT_EQ(2, *cache.find(120));
+  EXPECT_EQ(3, *cache.find(180));
+  std::lock_guard<std::mutex> lock(loader.state->mutex);
+  EXPECT_EQ(3u, loader.state->calls.size());
+  const std::map<packed_time, int>& calls = loader.state->calls;
+  for (std::map<packed_time, int>::const_iterator it = calls.begin(); it != calls.end(); ++it)
+    EXPECT_EQ(1, it->second) << "t=" << it->first;
+}
@@ -0,0 +1,172 @@
+
+#include "TimeFiles.h"
+#include "NameMatcher.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+namespace {
+TimeFilter make_filter(std::string pattern)
+{
+  TimeFilter tf(pattern);
+  return tf;
+}
+
+void set_mtime(const std::string& path, time_t t)
+{
+  struct timeval tv[2];
+  tv[0].tv_sec = tv[1].tv_sec = t;
+  tv[0].tv_usec = tv[1].tv_usec = 0;
+  utimes(path.c_str(), tv);
+}
+} // namespace
+
+TEST(TimeFilesTest, MakeName)
+{
+  std::string name;
+  const TimeFilter tf = make_filter("arome_[yyyymmdd]_[HH]_vc.nc");
+  EXPECT_TRUE(tf.makeName(pack_time(2015, 2, 1, 18, 0, 0), name));
+  EXPECT_EQ("arome_20150201_18_vc.nc", name);
+
+  const TimeFilter tf2 = make_filter("A[yy]/[mm]/[dd]/x_[HH][MM]");
+  EXPECT_TRUE(tf2.makeName(pack_time(2011, 1, 2, 3, 4, 0), name));
+  EXPECT_EQ("A11/01/02/x_0304", name);
+  EXPECT_FALSE(tf2.makeName(pack_time(1911, 1, 2, 3, 4, 0), name));
+
+  // other wildcards cannot be filled in
+  EXPECT_FALSE(make_filter("C11_[yyyymmddHHMM]+?H?M").makeName(pack_time(2011, 1, 2, 3, 4, 0), name));
+  EXPECT_FALSE(make_filter("no_time").makeName(pack_time(2011, 1, 2, 3, 4, 0), name));
+}
+
+TEST(TimeFilesTest, MakeNames)
+{
+  const TimeFilter tf = make_filter("daily_[yyyymmdd].txt");
+  std::vector<TimeFile> files;
+  make_time_names(tf, TimeAxis(pack_time(2015, 2, 1, 0, 0, 0), 6*3600, 8).times(), files);
+  ASSERT_EQ(2u, files.size());
+  EXPECT_EQ("daily_20150201.txt", files[0].name);
+  EXPECT_EQ(pack_time(2015, 2, 1, 12, 0, 0), files[0].time);
+  EXPECT_EQ("daily_20150202.txt", files[1].name);
+}
+
+TEST(TimeFilesTest, Find)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+
+  touch(dir + "/ec_2015020100.grb");
+  touch(dir + "/ec_2015020112.grb");
+  touch(dir + "/ec_2015020200.grb");
+  mkdir((dir + "/ec_2015020106.grb").c_str(), 0755);
+
+  const TimeFilter tf = make_filter("ec_[yyyymmddHH].grb");
+  std::vector<TimeFile> files;
+  ASSERT_TRUE(find_time_files(dir, tf, TimeAxis(pack_time(2015, 2, 1, 0, 0, 0), 6*3600, 4), files));
+  ASSERT_EQ(2u, files.size());
+  EXPECT_EQ("ec_2015020100.grb", files[0].name);
+  EXPECT_EQ("ec_2015020112.grb", files[1].name);
+  EXPECT_EQ(pack_time(2015, 2, 1, 12, 0, 0), files[1].time);
+
+  // threads give the same result
+  std::vector<TimeFile> files_mt;
+  ASSERT_TRUE(find_time_files(dir, tf, TimeAxis(pack_time(2015, 1, 1, 0, 0, 0), 3600, 2000), files_mt, 4));
+  ASSERT_EQ(3u, files_mt.size());
+  EXPECT_EQ("ec_2015020200.grb", files_mt[2].name);
+
+  EXPECT_FALSE(find_time_files(dir + "/missing", tf, TimeAxis(pack_time(2015, 2, 1, 0, 0, 0), 3600, 2), files));
+}
+
+TEST(TimeFilesTest, TreeFiles)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+
+  const char* dirs[] = { "/2014", "/2014/12", "/2014/12/31", "/2015", "/2015/01", "/2015/01/31",
+                         "/2015/02", "/2015/02/01", "/2015/02/02", "/2015/xx" };
+  for (size_t i=0; i<sizeof(dirs)/sizeof(dirs[0]); ++i)
+    mkdir((dir + dirs[i]).c_str(), 0755);
+  touch(dir + "/2014/12/31/product_2014123118.nc");
+  // would be in range, but its directory is not
+  touch(dir + "/2014/12/31/product_2015020100.nc");
+  touch(dir + "/2015/01/31/product_2015013118.nc");
+  touch(dir + "/2015/02/01/product_2015020100.nc");
+  touch(dir + "/2015/02/01/product_2015020112.nc");
+  touch(dir + "/2015/02/01/README");
+  touch(dir + "/2015/02/02/product_2015020200.nc");
+
+  std::vector<TimeFile> files;
+  ASSERT_TRUE(find_time_tree_files(dir, "[yyyy]/[mm]/[dd]/product_[yyyymmddHH].nc",
+          pack_time(2015, 1, 31, 12, 0, 0), pack_time(2015, 2, 1, 12, 0, 0), files));
+  ASSERT_EQ(3u, files.size());
+  EXPECT_EQ("2015/01/31/product_2015013118.nc", files[0].name);
+  EXPECT_EQ(pack_time(2015, 1, 31, 18, 0, 0), files[0].time);
+  EXPECT_EQ("2015/02/01/product_2015020100.nc", files[1].name);
+  EXPECT_EQ("2015/02/01/product_2015020112.nc", files[2].name);
+
+  // time only from directories, hour 12 by default
+  ASSERT_TRUE(find_time_tree_files(dir, "[yyyy]/[mm]/[dd]/README",
+          pack_time(2015, 1, 1, 0, 0, 0), pack_time(2015, 12, 31, 0, 0, 0), files));
+  ASSERT_EQ(1u, files.size());
+  EXPECT_EQ(pack_time(2015, 2, 1, 12, 0, 0), files[0].time);
+
+  EXPECT_FALSE(find_time_tree_files(dir, "[yyyy]/[qq]/x", pack_time(2015, 1, 1, 0, 0, 0),
+          pack_time(2015, 12, 31, 0, 0, 0), files));
+}
+
+TEST(TimeFilesTest, Newest)
+{
+  TempDir tmp;
+  const std::string& dir = tmp.path;
+  ASSERT_FALSE(dir.empty());
+
+  // name times and mtimes in opposite order
+  const char* names[] = { "ec_2015020100.grb", "ec_2015020106.grb", "ec_2015020112.grb",
+                          "ec_2015020118.grb", "ec_2015020200.grb", "README" };
+  const size_t n = sizeof(names)/sizeof(names[0]);
+  for (size_t i=0; i<n; ++i) {
+    touch(dir + "/" + names[i]);
+    set_mtime(dir + "/" + names[i], 1000000 - 100*i);
+  }
+  set_mtime(dir + "/README", 1000000);
+  mkdir((dir + "/ec_2015030100.grb").c_str(), 0755);
+
+  std::vector<TimeFile> files;
+  ASSERT_TRUE(find_newest_files(dir, 3, NEWEST_BY_MTIME, NameMatcher(), files));
+  ASSERT_EQ(3u, files.size());
+  // equal mtime by name
+  EXPECT_EQ("README", files[0].name);
+  EXPECT_EQ("ec_2015020100.grb", files[1].name);
+  EXPECT_EQ(1000000, files[1].time);
+  EXPECT_EQ("ec_2015020106.grb", files[2].name);
+
+  ASSERT_TRUE(find_newest_files(dir, 2, NEWEST_BY_MTIME, NameMatcher::glob("ec_*.grb"), files));
+  ASSERT_EQ(2u, files.size());
+  EXPECT_EQ("ec_2015020100.grb", files[0].name);
+
+  ASSERT_TRUE(find_newest_files(dir, 100, NEWEST_BY_CTIME, NameMatcher::glob("ec_*.grb"), files));
+  EXPECT_EQ(5u, files.size());
+
+  const TimeFilter tf = make_filter("ec_[yyyymmddHH].grb");
+  ASSERT_TRUE(find_newest_files(dir, 2, tf, files));
+  ASSERT_EQ(2u, files.size());
+  EXPECT_EQ("ec_2015020200.grb", files[0].name);
+  EXPECT_EQ(pack_time(2015, 2, 2, 0, 0, 0), files[0].time);
+  EXPECT_EQ("ec_2015020118.grb", files[1].name);
+
+  ASSERT_TRUE(find_newest_files(dir, 0, tf, files));
+  EXPECT_TRUE(files.empty());
+  EXPECT_FALSE(find_newest_files(dir + "/missing", 2, tf, files));
+  EXPECT_FALSE(find_newest_files(dir, 2, make_filter("[yyyy]/ec_[mmddHH].grb"), files));
+}
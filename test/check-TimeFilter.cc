@@ -1,5 +1,7 @@
 
 #include <TimeFilter.h>
+#include <TimeFilterSet.h>
+#include <miStringFunctions.h>
 
 #include <gtest/gtest.h>
 
@@ -36,3 +38,197 @@ TEST(TimeFilterTest, Time)
   EXPECT_EQ("2015-02-01T18:00:00", tf_timestring("arome_[yyyymmdd]_[HH]_vc.nc", "test/arome_20150201_18_vc.nc"));
 
 }
+
+TEST(TimeFilterTest, Batch)
+{
+  std::string pattern = "arome_[yyyymmdd]_[HH]_vc.nc";
+  miutil::TimeFilter tf(pattern);
+
+  std::vector<std::string> names;
+  for (int i=0; i<5000; ++i) {
+    names.push_back("test/arome_201502" + miutil::from_number(i % 40, 2) + "_18_vc.nc");
+    names.push_back("README");
+    names.push_back("arome_2015020x_18_vc.nc");
+  }
+
+  std::vector<miutil::packed_time> times;
+  std::vector<bool> matched;
+  const size_t n = tf.getTimes(names, times, matched, 4);
+  ASSERT_EQ(names.size(), times.size());
+  ASSERT_EQ(names.size(), matched.size());
+  EXPECT_EQ(5000u * 29 / 40, n); // day 00 is accepted, like getTime does
+
+  for (size_t i=0; i<names.size(); ++i) {
+    miutil::miTime t;
+    const bool ok = tf.getTime(names[i], t);
+    EXPECT_EQ(ok, matched[i]) << names[i];
+    if (ok)
+      EXPECT_EQ(miutil::pack_time(t), times[i]) << names[i];
+    else
+      EXPECT_EQ(miutil::PACKED_TIME_UNDEF, times[i]) << names[i];
+  }
+
+  std::vector<miutil::packed_time> times1;
+  std::vector<bool> matched1;
+  EXPECT_EQ(n, tf.getTimes(names, times1, matched1, 1));
+  EXPECT_EQ(times, times1);
+}
+
+// ------------------------------------------------------------------------
+
+TEST(TimeFilterSetTest, Match)
+{
+  miutil::TimeFilterSet fs;
+  EXPECT_EQ(0, fs.add("arome_[yyyymmdd]_[HH]_vc.nc"));
+  EXPECT_EQ(1, fs.add("ec_[yyyymmddHH].grb*"));
+  EXPECT_EQ(2, fs.add("obs/[yyyy]/[mm]/[dd]/synop_[HH].txt"));
+  EXPECT_EQ(-1, fs.add("no_time.nc"));
+  EXPECT_EQ(3, fs.add("ec_[yyyymmdd]??.grb"));
+  fs.compile();
+
+  miutil::miTime t;
+  EXPECT_EQ(0, fs.match("test/arome_20150201_18_vc.nc", t));
+  EXPECT_EQ("2015-02-01T18:00:00", t.isoTime("T"));
+  EXPECT_EQ(-1, fs.match("test/arome_20150201_18_vc.nc.bak", t));
+  EXPECT_EQ(-1, fs.match("arome_2015020x_18_vc.nc", t));
+
+  EXPECT_EQ(1, fs.match("ec_2015020112.grb", t));
+  EXPECT_EQ("2015-02-01T12:00:00", t.isoTime("T"));
+  EXPECT_EQ(1, fs.match("ec_2015020112.grb2", t));
+  // hour 25 is invalid for pattern 1; pattern 3 does not read the hour
+  EXPECT_EQ(3, fs.match("ec_2015020125.grb", t));
+  EXPECT_EQ("2015-02-01T12:00:00", t.isoTime("T"));
+
+  // patterns with '/' apply to the whole name
+  EXPECT_EQ(2, fs.match("obs/2015/02/03/synop_06.txt", t));
+  EXPECT_EQ("2015-02-03T06:00:00", t.isoTime("T"));
+  EXPECT_EQ(-1, fs.match("/data/obs/2015/02/03/synop_06.txt", t));
+
+  // added after compile(), tried one by one
+  EXPECT_EQ(4, fs.add("hirlam_[yyyymmddHH].nc"));
+  EXPECT_EQ(4, fs.match("hirlam_2015020100.nc", t));
+  EXPECT_EQ(0, fs.match("arome_20150201_18_vc.nc", t));
+}
+
+TEST(TimeFilterSetTest, Batch)
+{
+  miutil::TimeFilterSet fs;
+  for (int i=0; i<100; ++i)
+    fs.add("model" + miutil::from_number(i) + "_[yyyymmddHH].nc");
+  fs.add("model?_[yyyymmdd].txt*");
+  fs.compile();
+
+  std::vector<std::string> names;
+  for (int i=0; i<1000; ++i) {
+    names.push_back("dir/model" + miutil::from_number(i % 120) + "_20150201" + miutil::from_number(i % 30, 2) + ".nc");
+    names.push_back("model" + miutil::from_number(i % 10) + "_20150201.txt.gz");
+  }
+
+  std::vector<int> indices;
+  std::vector<miutil::packed_time> times;
+  fs.match(names, indices, times);
+  ASSERT_EQ(names.size(), indices.size());
+  for (size_t i=0; i<names.size(); ++i) {
+    // reference: first filter with a valid time
+    int expected = -1;
+    miutil::packed_time et = miutil::PACKED_TIME_UNDEF;
+    const std::string base = names[i].substr(names[i].find_last_of('/') + 1);
+    for (size_t f=0; f<fs.size() && expected < 0; ++f) {
+      miutil::packed_time pt;
+      const std::string& p = fs.filter(f).pattern();
+      const bool star = p[p.size()-1] == '*';
+      const size_t length = p.size() - (star ? 1 : 0);
+      if (base.size() < length || (!star && base.size() != length))
+        continue;
+      bool same = true;
+      for (size_t c=0; c<length && same; ++c)
+        same = (p[c] == '?' || p[c] == base[c]);
+      if (same && fs.filter(f).getTime(names[i], pt)) {
+        expected = f;
+        et = pt;
+      }
+    }
+    EXPECT_EQ(expected, indices[i]) << names[i];
+    EXPECT_EQ(et, times[i]) << names[i];
+  }
+}
+
+// ------------------------------------------------------------------------
+
+TEST(TimeFilterTest, Groups)
+{
+  std::string pattern = "ec_[ref:yyyymmddHH]_[valid:yyyymmddHH].grb";
+  miutil::TimeFilter tf(pattern);
+  ASSERT_TRUE(tf.ok());
+  EXPECT_EQ("ec_??????????_??????????.grb", pattern);
+  ASSERT_EQ(2u, tf.groupCount());
+  EXPECT_EQ(0, tf.group("ref"));
+  EXPECT_EQ(1, tf.group("valid"));
+  EXPECT_EQ(-1, tf.group(""));
+  EXPECT_FALSE(tf.hasLead());
+
+  const std::string name = "ec_2015020100_2015020318.grb";
+  EXPECT_EQ("2015-02-01T00:00:00", tf.getTimeStr(name));
+  miutil::packed_time t;
+  ASSERT_TRUE(tf.getGroupTime(name, 1, t));
+  EXPECT_EQ(miutil::pack_time(2015, 2, 3, 18, 0, 0), t);
+
+  miutil::packed_time times[2], lead = -1;
+  ASSERT_TRUE(tf.getGroupTimes(name, times, lead));
+  EXPECT_EQ(miutil::pack_time(2015, 2, 1, 0, 0, 0), times[0]);
+  EXPECT_EQ(miutil::pack_time(2015, 2, 3, 18, 0, 0), times[1]);
+  EXPECT_EQ(0, lead);
+  EXPECT_FALSE(tf.getGroupTimes("ec_2015020100_2015023318.grb", times, lead));
+
+  // names are only taken if they are identifiers without time fields
+  std::string hm = "obs_[yyyymmdd]_[HH:MM].txt";
+  miutil::TimeFilter tf_hm(hm);
+  EXPECT_EQ(1u, tf_hm.groupCount());
+  EXPECT_EQ("2015-02-01T06:30:00", tf_hm.getTimeStr("obs_20150201_06:30.txt"));
+
+  std::string iso = "obs_[yyyy-mm-ddTHH:MM].txt";
+  miutil::TimeFilter tf_iso(iso);
+  ASSERT_TRUE(tf_iso.ok());
+  EXPECT_EQ(1u, tf_iso.groupCount());
+  EXPECT_EQ("2015-02-01T06:30:00", tf_iso.getTimeStr("obs_2015-02-01T06:30.txt"));
+
+  std::string under = "obs_[yyyymmdd_HH:MM].txt";
+  miutil::TimeFilter tf_under(under);
+  ASSERT_TRUE(tf_under.ok());
+  EXPECT_EQ(1u, tf_under.groupCount());
+  EXPECT_EQ("2015-02-01T06:30:00", tf_under.getTimeStr("obs_20150201_06:30.txt"));
+}
+
+TEST(TimeFilterTest, Lead)
+{
+  std::string pattern = "ec_[yyyymmddHH]_+[HHH].grb";
+  miutil::TimeFilter tf(pattern);
+  ASSERT_TRUE(tf.ok());
+  EXPECT_EQ("ec_??????????_+???.grb", pattern);
+  EXPECT_EQ(1u, tf.groupCount());
+  EXPECT_TRUE(tf.hasLead());
+
+  const std::string name = "ec_2015020112_+054.grb";
+  EXPECT_EQ("2015-02-01T12:00:00", tf.getTimeStr(name));
+  miutil::packed_time t;
+  ASSERT_TRUE(tf.getValidTime(name, t));
+  EXPECT_EQ(miutil::pack_time(2015, 2, 3, 18, 0, 0), t);
+
+  miutil::packed_time times[1], lead = 0;
+  ASSERT_TRUE(tf.getGroupTimes(name, times, lead));
+  EXPECT_EQ(54*3600, lead);
+  EXPECT_FALSE(tf.getValidTime("ec_2015020112_+05x.grb", t));
+
+  std::string name_out;
+  EXPECT_FALSE(tf.makeName(miutil::pack_time(2015, 2, 1, 12, 0, 0), name_out));
+
+  std::string named = "ec_[ref:yyyymmddHH]_[HHHH]";
+  miutil::TimeFilter tf_named(named);
+  ASSERT_TRUE(tf_named.ok());
+  EXPECT_EQ(1u, tf_named.groupCount());
+  ASSERT_TRUE(tf_named.getValidTime("ec_2015020100_0024", t));
+  EXPECT_EQ(miutil::pack_time(2015, 2, 2, 0, 0, 0), t);
+
+  std::string two_leads = "ec_[yyyymmddHH]_[HHH]_[HHH]";
+  EXPECT_FALSE(miutil::TimeFilter(two_leads).ok());
+}
@@ -0,0 +1,75 @@
+
+#include "TimeLists.h"
+
+#include <gtest/gtest.h>
+
+using namespace miutil;
+
+namespace {
+std::vector<packed_time> make_list(std::initializer_list<packed_time> t)
+{
+  return std::vector<packed_time>(t);
+}
+} // namespace
+
+TEST(TimeListsTest, Merge)
+{
+  std::vector<std::vector<packed_time> > lists;
+  lists.push_back(make_list({ 1, 4, 7 }));
+  lists.push_back(make_list({ 2, 4 }));
+  lists.push_back(make_list({ }));
+  lists.push_back(make_list({ 0, 9 }));
+
+  std::vector<packed_time> merged;
+  merge_times(lists, merged);
+  EXPECT_EQ(make_list({ 0, 1, 2, 4, 4, 7, 9 }), merged);
+
+  std::vector<packed_time> result;
+  union_times(lists, result);
+  EXPECT_EQ(make_list({ 0, 1, 2, 4, 7, 9 }), result);
+
+  intersect_times(lists, result);
+  EXPECT_TRUE(result.empty());
+}
+
+TEST(TimeListsTest, RegularAxis)
+{
+  std::vector<std::vector<packed_time> > lists;
+  lists.push_back(make_list({ 3600, 7200, 10800, 14400 }));
+  lists.push_back(make_list({ 0, 7200, 14400, 21600 }));
+  lists.push_back(make_list({ 7200, 14400, 14400 }));
+
+  TimeAxis axis;
+  time_list_ptrs ptrs;
+  for (size_t i=0; i<lists.size(); ++i)
+    ptrs.push_back(&lists[i]);
+  ASSERT_TRUE(common_time_axis(ptrs, axis));
+  EXPECT_EQ(0, axis.start());
+  EXPECT_EQ(3600, axis.step());
+  EXPECT_EQ(7u, axis.size());
+
+  std::vector<packed_time> result;
+  union_times(lists, result);
+  EXPECT_EQ(make_list({ 0, 3600, 7200, 10800, 14400, 21600 }), result);
+
+  intersect_times(lists, result);
+  EXPECT_EQ(make_list({ 7200, 14400 }), result);
+
+  // tolerance >= step disables the bitset path
+  union_times(lists, result, 3600);
+  EXPECT_EQ(make_list({ 0, 7200, 14400, 21600 }), result);
+}
+
+TEST(TimeListsTest, Tolerance)
+{
+  std::vector<std::vector<packed_time> > lists;
+  lists.push_back(make_list({ 0, 598, 1200 }));
+  lists.push_back(make_list({ 1, 601, 1805 }));
+
+  std::vector<packed_time> result;
+  intersect_times(lists, result, 5);
+  EXPECT_EQ(make_list({ 0, 598 }), result);
+
+  union_times(lists, result, 5);
+  EXPECT_EQ(make_list({ 0, 598, 1200, 1805 }), result);
+}
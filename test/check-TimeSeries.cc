@@ -0,0 +1,161 @@
+
+#include "TimeSeries.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+
+using namespace miutil;
+
+TEST(PackedTimeTest, Pack)
+{
+  EXPECT_EQ(0, pack_time(1970, 1, 1));
+  EXPECT_EQ(951782400, pack_time(2000, 2, 29));
+  EXPECT_EQ(-86400, pack_time(1969, 12, 31));
+  EXPECT_EQ(PACKED_TIME_UNDEF, pack_time(miTime()));
+
+  const miTime t(2013, 1, 1, 22, 58, 58);
+  EXPECT_EQ(t, unpack_time(pack_time(t)));
+  EXPECT_EQ(miTime(1900, 3, 1, 0, 0, 1), unpack_time(pack_time(1900, 3, 1, 0, 0, 1)));
+  EXPECT_TRUE(unpack_time(PACKED_TIME_UNDEF).undef());
+
+  const miTime t0(2015, 2, 1, 18, 0, 0);
+  miTime t1(t0);
+  t1.addSec(1234567);
+  EXPECT_EQ(miTime::secDiff(t1, t0), pack_time(t1) - pack_time(t0));
+}
+
+TEST(PackedTimeTest, ParseIso)
+{
+  packed_time t = 0;
+  const char* text = "2015-02-01 18:00:05.123Z rest";
+  const char* end = text + strlen(text);
+  EXPECT_EQ(text + 24, parse_iso_time(text, end, t));
+  EXPECT_EQ(pack_time(2015, 2, 1, 18, 0, 5), t);
+
+  const char* text2 = "2015-02-01T18:30 x";
+  EXPECT_EQ(text2 + 16, parse_iso_time(text2, text2 + strlen(text2), t));
+  EXPECT_EQ(pack_time(2015, 2, 1, 18, 30), t);
+
+  const char* text3 = "2015-02-01 text";
+  EXPECT_EQ(text3 + 10, parse_iso_time(text3, text3 + strlen(text3), t));
+  EXPECT_EQ(pack_time(2015, 2, 1), t);
+
+  const char* bad[] = { "2015-02-30", "2015-2-01", "2015-02-01 25:00", "x2015-02-01", "2015-02" };
+  for (size_t i=0; i<sizeof(bad)/sizeof(bad[0]); ++i)
+    EXPECT_EQ(0, parse_iso_time(bad[i], bad[i] + strlen(bad[i]), t)) << bad[i];
+}
+
+TEST(PackedTimeTest, TimeAxis)
+{
+  const TimeAxis axis(pack_time(2015, 2, 1), 3600, 24);
+  EXPECT_EQ(pack_time(2015, 2, 1, 23), axis.last());
+
+  size_t i = 0;
+  EXPECT_TRUE(axis.index(pack_time(2015, 2, 1, 6), i));
+  EXPECT_EQ(6u, i);
+  EXPECT_FALSE(axis.index(pack_time(2015, 2, 1, 6, 30), i));
+  EXPECT_FALSE(axis.index(pack_time(2015, 2, 2), i));
+  EXPECT_EQ(24u, axis.times().size());
+}
+
+namespace {
+const float UNDEF = -32767;
+const packed_time T0 = 1000000;
+
+void make_source(std::vector<packed_time>& st, std::vector<float>& sv)
+{
+  const packed_time times[5] = { T0, T0 + 600, T0 + 1800, T0 + 2400, T0 + 3600 };
+  const float values[5] = { 0, 10, UNDEF, 40, 60 };
+  st.assign(times, times + 5);
+  sv.assign(values, values + 5);
+}
+} // namespace
+
+TEST(TimeSeriesTest, ResampleNearestPrevious)
+{
+  std::vector<packed_time> st;
+  std::vector<float> sv;
+  make_source(st, sv);
+
+  const TimeAxis axis(T0 - 600, 1200, 5); // -600, 600, 1800, 3000, 4200
+  std::vector<float> out;
+
+  ASSERT_TRUE(resample(st, sv, axis, out, RESAMPLE_NEAREST, UNDEF));
+  ASSERT_EQ(5u, out.size());
+  EXPECT_EQ(0, out[0]);
+  EXPECT_EQ(10, out[1]);
+  EXPECT_EQ(40, out[2]); // 1800 is missing, 2400 is closer than 600
+  EXPECT_EQ(40, out[3]);
+  EXPECT_EQ(60, out[4]);
+
+  ASSERT_TRUE(resample(st, sv, axis, out, RESAMPLE_NEAREST, UNDEF, 300));
+  EXPECT_EQ(UNDEF, out[0]);
+  EXPECT_EQ(10, out[1]);
+  EXPECT_EQ(UNDEF, out[2]);
+
+  ASSERT_TRUE(resample(st, sv, axis, out, RESAMPLE_PREVIOUS, UNDEF));
+  EXPECT_EQ(UNDEF, out[0]);
+  EXPECT_EQ(10, out[1]);
+  EXPECT_EQ(10, out[2]);
+  EXPECT_EQ(40, out[3]);
+  EXPECT_EQ(60, out[4]);
+}
+
+TEST(TimeSeriesTest, ResampleLinear)
+{
+  std::vector<packed_time> st;
+  std::vector<float> sv;
+  make_source(st, sv);
+
+  const packed_time targets[4] = { T0 + 300, T0 + 1800, T0 + 3000, T0 + 3600 };
+  const std::vector<packed_time> dt(targets, targets + 4);
+  std::vector<float> out;
+
+  ASSERT_TRUE(resample(st, sv, dt, out, RESAMPLE_LINEAR, UNDEF));
+  EXPECT_FLOAT_EQ(5, out[0]);
+  EXPECT_FLOAT_EQ(30, out[1]);
+  EXPECT_FLOAT_EQ(50, out[2]);
+  EXPECT_FLOAT_EQ(60, out[3]);
+
+  ASSERT_TRUE(resample(st, sv, dt, out, RESAMPLE_LINEAR, UNDEF, 900));
+  EXPECT_FLOAT_EQ(5, out[0]);
+  EXPECT_EQ(UNDEF, out[1]);
+  EXPECT_FLOAT_EQ(50, out[2]);
+}
+
+TEST(TimeSeriesTest, ResampleMean)
+{
+  std::vector<packed_time> st;
+  std::vector<float> sv;
+  make_source(st, sv);
+
+  const packed_time targets[3] = { T0 + 600, T0 + 2400, T0 + 10000 };
+  const std::vector<packed_time> dt(targets, targets + 3);
+  std::vector<float> out;
+
+  ASSERT_TRUE(resample(st, sv, dt, out, RESAMPLE_MEAN, UNDEF, 600));
+  EXPECT_FLOAT_EQ(5, out[0]);
+  EXPECT_FLOAT_EQ(40, out[1]);
+  EXPECT_EQ(UNDEF, out[2]);
+}
+
+TEST(TimeSeriesTest, ResampleUnsortedTargetsNaN)
+{
+  const packed_time times[3] = { 0, 10, 20 };
+  const double values[3] = { 1, NAN, 3 };
+  const std::vector<packed_time> st(times, times + 3);
+  const std::vector<double> sv(values, values + 3);
+
+  const packed_time targets[3] = { 20, 0, 10 };
+  const std::vector<packed_time> dt(targets, targets + 3);
+  std::vector<double> out;
+
+  ASSERT_TRUE(resample(st, sv, dt, out, RESAMPLE_LINEAR, NAN));
+  EXPECT_DOUBLE_EQ(3, out[0]);
+  EXPECT_DOUBLE_EQ(1, out[1]);
+  EXPECT_DOUBLE_EQ(2, out[2]);
+
+  EXPECT_FALSE(resample(st, std::vector<double>(2), dt, out, RESAMPLE_LINEAR, NAN));
+}
@@ -0,0 +1,73 @@
+
+#include "TimestampedFile.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+using namespace miutil;
+
+namespace {
+std::string write_temp(const std::string& content)
+{
+  char name[] = "/tmp/putools_tsf_XXXXXX";
+  const int fd = mkstemp(name);
+  if (fd < 0)
+    return std::string();
+  if (write(fd, content.data(), content.size()) != static_cast<ssize_t>(content.size())) {
+    close(fd);
+    return std::string();
+  }
+  close(fd);
+  return name;
+}
+
+std::string range(const TimestampedFile& f, packed_time t1, packed_time t2)
+{
+  size_t b = 0, e = 0;
+  if (!f.findRange(t1, t2, b, e))
+    return std::string();
+  return std::string(f.data() + b, e - b);
+}
+} // namespace
+
+TEST(TimestampedFileTest, FindRange)
+{
+  const std::string content =
+      "log file header\n"
+      "2015-02-01 00:00:00 start\n"
+      "2015-02-01 06:00:00 a\n"
+      "  continued\n"
+      "2015-02-01 06:00:00 b\n"
+      "[2015-02-01T12:00:00Z] c\n"
+      "2015-02-01 18:00:00 d\n"
+      "2015-02-02 00:00:00 end";
+  const std::string path = write_temp(content);
+  ASSERT_FALSE(path.empty());
+
+  TimestampedFile f(path);
+  ASSERT_TRUE(f.isOpen());
+  EXPECT_EQ(content.size(), f.size());
+
+  EXPECT_EQ("2015-02-01 06:00:00 a\n  continued\n2015-02-01 06:00:00 b\n[2015-02-01T12:00:00Z] c\n",
+      range(f, pack_time(2015, 2, 1, 1), pack_time(2015, 2, 1, 12)));
+  EXPECT_EQ("2015-02-01 18:00:00 d\n2015-02-02 00:00:00 end",
+      range(f, pack_time(2015, 2, 1, 13), pack_time(2015, 3, 1)));
+  EXPECT_EQ("", range(f, pack_time(2015, 2, 1, 7), pack_time(2015, 2, 1, 8)));
+  EXPECT_EQ(content.size() - 23, f.lowerBound(pack_time(2015, 2, 2)));
+  EXPECT_EQ(content.size(), f.upperBound(pack_time(2015, 2, 2)));
+  EXPECT_EQ(16u, f.lowerBound(pack_time(2000, 1, 1)));
+
+  size_t b = 0, e = 0, n = 0;
+  ASSERT_TRUE(f.findRange(pack_time(2015, 2, 1, 6), pack_time(2015, 2, 1, 6), b, e));
+  const char* line;
+  size_t length;
+  while (f.nextLine(b, e, line, length))
+    n += 1;
+  EXPECT_EQ(3u, n);
+
+  unlink(path.c_str());
+}
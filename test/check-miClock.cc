@@ -7,11 +7,14 @@
 #endif
 
 #include "miTime.h"
+#include "FormatContext.h"
 #include <gtest/gtest.h>
 
 using miutil::miClock;
 using miutil::miDate;
 using miutil::miTime;
+using miutil::FormatContext;
+using miutil::ScopedFormatContext;
 
 TEST(MiClockTest, ctor)
 {
@@ -80,6 +83,29 @@ TEST(MiTimeTest, format)
     }
 }
 
+TEST(MiTimeTest, formatContext)
+{
+    const miTime t(2013, 1, 6, 22, 58, 58);
+    EXPECT_EQ("Sunday 22", t.format("%A %H"));
+    EXPECT_EQ("S\370ndag 23", t.format("%A %H", FormatContext("no", false, "CET")));
+    EXPECT_EQ("Søndag 22", t.format("%A %H", FormatContext("no", true)));
+    EXPECT_EQ("Montag 00 EET", t.format("%A %H %tz", FormatContext("de", false, "EET")));
+
+    {
+        ScopedFormatContext sc(FormatContext("no", true));
+        EXPECT_EQ("Søndag", t.format("%A"));
+        EXPECT_EQ("Sunday", t.format("%A", "en"));
+        EXPECT_EQ("S\370ndag", t.format("%A", "", false));
+        {
+            ScopedFormatContext sc_inner(FormatContext("", false, "CET"));
+            EXPECT_EQ("Sunday 23", t.format("%A %H"));
+        }
+        EXPECT_EQ("Søn", t.date().format("%a"));
+    }
+    EXPECT_EQ(0, FormatContext::current());
+    EXPECT_EQ("Sunday", t.format("%A"));
+}
+
 TEST(MiDateTest, format)
 {
     {
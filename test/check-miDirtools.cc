@@ -0,0 +1,121 @@
+
+#include "miDirtools.h"
+#include "NameMatcher.h"
+#include "TestTempDir.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace miutil;
+using namespace putools_test;
+
+TEST(MiDirtoolsTest, ScanDirectory)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+  write_file(dir.path + "/a.txt", 10);
+  write_file(dir.path + "/b.dat", 2000);
+  mkdir((dir.path + "/sub").c_str(), 0755);
+  ASSERT_EQ(0, symlink("a.txt", (dir.path + "/link").c_str()));
+
+  DirEntries entries;
+  ASSERT_TRUE(scan_directory(dir.path, SCAN_NAMES, entries));
+  ASSERT_EQ(4u, entries.size());
+
+  ASSERT_TRUE(scan_directory(dir.path, SCAN_TYPE | SCAN_SIZE | SCAN_MTIME, entries));
+  ASSERT_EQ(4u, entries.size());
+  for (size_t i=0; i<entries.size(); ++i) {
+    const std::string name = entries.name(i);
+    EXPECT_EQ(name.size(), entries.nameLength(i));
+    EXPECT_GT(entries.mtime(i), 0);
+    if (name == "a.txt" || name == "link") {
+      // links are followed when stat'ing
+      EXPECT_EQ(DirEntries::TYPE_FILE, entries.type(i)) << name;
+      EXPECT_EQ(10, entries.fileSize(i)) << name;
+    } else if (name == "b.dat") {
+      EXPECT_EQ(2000, entries.fileSize(i));
+    } else {
+      EXPECT_EQ("sub", name);
+      EXPECT_EQ(DirEntries::TYPE_DIR, entries.type(i));
+    }
+  }
+
+  ASSERT_TRUE(scan_directory(dir.path, SCAN_DOTS, entries));
+  EXPECT_EQ(6u, entries.size());
+
+  EXPECT_FALSE(scan_directory(dir.path + "/missing", SCAN_NAMES, entries));
+  EXPECT_TRUE(entries.empty());
+}
+
+TEST(MiDirtoolsTest, ScanLarge)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+  // more entries than fit in one batch
+  const int N = 5000;
+  for (int i=0; i<N; ++i) {
+    char name[64];
+    snprintf(name, sizeof(name), "/file_with_a_rather_long_name_%05d", i);
+    write_file(dir.path + name, 0);
+  }
+
+  DirEntries entries;
+  ASSERT_TRUE(scan_directory(dir.path, SCAN_NAMES, entries));
+  ASSERT_EQ(size_t(N), entries.size());
+
+  std::vector<std::string> names;
+  ASSERT_TRUE(getFilenames(dir.path, names));
+  EXPECT_EQ(size_t(N + 2), names.size());
+  std::sort(names.begin(), names.end());
+  EXPECT_EQ(".", names[0]);
+  EXPECT_EQ("..", names[1]);
+  EXPECT_EQ("file_with_a_rather_long_name_00000", names[2]);
+}
+
+TEST(MiDirtoolsTest, ScanDescriptor)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+  const std::string sub = dir.path + "/sub";
+  ASSERT_EQ(0, mkdir(sub.c_str(), 0755));
+  write_file(sub + "/a.grb", 0);
+  write_file(sub + "/b.txt", 0);
+
+  const int dfd = open(sub.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  ASSERT_GE(dfd, 0);
+  // still the same directory after it is moved and replaced
+  ASSERT_EQ(0, rename(sub.c_str(), (dir.path + "/old").c_str()));
+  ASSERT_EQ(0, mkdir(sub.c_str(), 0755));
+
+  // read from the start each time
+  for (int pass=0; pass<2; ++pass) {
+    std::vector<std::string> names;
+    EXPECT_TRUE(scan_directory_batches(dfd, SCAN_TYPE, NameMatcher::extension("grb"),
+            [&names](const DirEntries& entries) {
+              for (size_t i=0; i<entries.size(); ++i)
+                names.push_back(entries.name(i));
+            }));
+    ASSERT_EQ(1u, names.size());
+    EXPECT_EQ("a.grb", names[0]);
+  }
+  close(dfd);
+
+  EXPECT_FALSE(scan_directory_batches(-1, SCAN_NAMES, NameMatcher(), [](const DirEntries&) { }));
+}
+
+TEST(MiDirtoolsTest, GetRecent)
+{
+  TempDir dir;
+  ASSERT_FALSE(dir.path.empty());
+  EXPECT_EQ("", getRecent(dir.path));
+  write_file(dir.path + "/a.txt", 1);
+  EXPECT_EQ(dir.path + "/a.txt", getRecent(dir.path));
+  EXPECT_EQ("", getRecent(dir.path + "/missing"));
+}
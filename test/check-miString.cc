@@ -128,6 +128,92 @@ TEST(miStringTest, split_protected)
     }
 }
 
+namespace {
+std::vector<std::string> to_strings(const std::vector<boost::string_ref>& tokens)
+{
+    std::vector<std::string> strings;
+    for (size_t i=0; i<tokens.size(); ++i)
+        strings.push_back(tokens[i].to_string());
+    return strings;
+}
+} // namespace
+
+TEST(miStringTest, split_ref_expected)
+{
+    typedef std::vector<std::string> strings;
+    struct Split { const char* text; int nos; const char* seps; bool clean; strings expected; };
+    const Split splits[] = {
+        { "", 0, " ", true, strings() },
+        { " ", 0, " ", false, { "" } },
+        { " this   is a  string  ", 0, " ", true, { "this", "is", "a", "string" } },
+        { " this   is a  string  ", 0, " ", false, { "", "this", "", "", "is", "a", "", "string", "" } },
+        { " this   is a  string  ", 2, " ", true, { "this", "is", "a  string" } },
+        { " this   is a  string  ", 2, " ", false, { "", "this", "  is a  string  " } },
+        { "a::b:", 0, ":", true, { "a", "b" } },
+        { "a::b:", 0, ":", false, { "a", "", "b" } },
+        { ":a: b :", 1, ":", true, { "a", "b :" } },
+        { ":a: b :", 1, ":", false, { "", "a: b :" } },
+        { "x\t y\r\n", 0, " \t", true, { "x", "y" } },
+    };
+    std::vector<boost::string_ref> tokens;
+    for (size_t i=0; i<boost::size(splits); ++i) {
+        const Split& sp = splits[i];
+        miutil::split(tokens, sp.text, sp.nos, sp.seps, sp.clean);
+        EXPECT_EQ(sp.expected, to_strings(tokens)) << "split " << i;
+        EXPECT_EQ(sp.expected, miutil::split(sp.text, sp.nos, sp.seps, sp.clean)) << "split " << i;
+    }
+
+    struct Protected { const char* text; const char* seps; bool clean; strings expected; };
+    const Protected protecteds[] = {
+        { " (protected text) in a  \"string  ", " ", true, { "(protected text)", "in", "a", "\"string" } },
+        { " (protected text) in a  \"string  ", " ", false, { "", "(protected text)", "in", "a", "", "\"string", "" } },
+        { "a,(b, c),d", ",", true, { "a", "(b, c)", "d" } },
+        // unbalanced border: only the tokens before it
+        { "(a) (b", " ", true, { "(a)" } },
+        { "x  (a) (b", " ", false, { "x", "", "(a)" } },
+    };
+    for (size_t i=0; i<boost::size(protecteds); ++i) {
+        const Protected& pr = protecteds[i];
+        miutil::split_protected(tokens, pr.text, '(', ')', pr.seps, pr.clean);
+        EXPECT_EQ(pr.expected, to_strings(tokens)) << "split_protected " << i;
+        EXPECT_EQ(pr.expected, miutil::split_protected(pr.text, '(', ')', pr.seps, pr.clean)) << "split_protected " << i;
+    }
+}
+
+TEST(miStringTest, split_ref)
+{
+    const char* texts[] = { "", " ", "one", " this   is a  string  ", "a::b:", ":a: b :",
+                            "x\t y\r\n", " (protected text) in a  \"string  ", "(a) (b", "a,(b, c),d" };
+    const char* seps[] = { " ", ":", ",", " \t" };
+
+    std::vector<boost::string_ref> tokens;
+    for (size_t t=0; t<boost::size(texts); ++t) {
+        const std::string text = texts[t];
+        for (size_t s=0; s<boost::size(seps); ++s) {
+            for (int clean=0; clean<2; ++clean) {
+                for (int nos=0; nos<3; ++nos) {
+                    miutil::split(tokens, text, nos, seps[s], clean);
+                    EXPECT_EQ(miutil::split(text, nos, seps[s], clean), to_strings(tokens))
+                        << "text='" << text << "' sep='" << seps[s] << "' nos=" << nos << " clean=" << clean;
+                }
+                miutil::split_protected(tokens, text, '(', ')', seps[s], clean);
+                EXPECT_EQ(miutil::split_protected(text, '(', ')', seps[s], clean), to_strings(tokens))
+                    << "text='" << text << "' sep='" << seps[s] << "' clean=" << clean;
+            }
+        }
+    }
+
+    // tokens point into the text, the buffer is reused
+    const std::string line = "12 34  56";
+    miutil::split(tokens, line);
+    ASSERT_EQ(3, tokens.size());
+    EXPECT_EQ(line.data() + 3, tokens[1].data());
+    const size_t capacity = tokens.capacity();
+    miutil::split(tokens, "7 8");
+    EXPECT_EQ(2, tokens.size());
+    EXPECT_EQ(capacity, tokens.capacity());
+}
+
 TEST(miStringTest, is_number)
 {
     EXPECT_TRUE(miutil::is_number(" 0.123 "));